@@ -16,11 +16,25 @@
 #define AGRPC_AGRPC_ASIOGRPC_HPP
 
 #include "agrpc/detail/grpcContextImplementation.ipp"
+#include "agrpc/balancer.hpp"
+#include "agrpc/batcher.hpp"
+#include "agrpc/broadcaster.hpp"
+#include "agrpc/channelPool.hpp"
+#include "agrpc/duplex.hpp"
 #include "agrpc/grpcContext.hpp"
 #include "agrpc/grpcContext.ipp"
 #include "agrpc/grpcExecutor.hpp"
 #include "agrpc/grpcSender.hpp"
+#include "agrpc/hedging.hpp"
 #include "agrpc/initiate.hpp"
+#include "agrpc/multiplexer.hpp"
+#include "agrpc/proxy.hpp"
+#include "agrpc/responseCache.hpp"
+#include "agrpc/retry.hpp"
 #include "agrpc/rpcs.hpp"
+#include "agrpc/singleFlight.hpp"
+#include "agrpc/streamReader.hpp"
+#include "agrpc/streamWriter.hpp"
+#include "agrpc/task.hpp"
 
 #endif  // AGRPC_AGRPC_ASIOGRPC_HPP
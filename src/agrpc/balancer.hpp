@@ -0,0 +1,212 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_BALANCER_HPP
+#define AGRPC_AGRPC_BALANCER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/balancer.hpp"
+#include "agrpc/initiate.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/channel.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <grpcpp/support/channel_arguments.h>
+#include <grpcpp/support/status.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace agrpc
+{
+// Client-side load balancer over a static list of backends. Each pick draws two random backends and returns the one
+// with the lower expected cost, which is the exponentially weighted moving average of its latency multiplied by its
+// number of in-flight calls plus one. Backends without a latency sample yet are always preferred. Thread-safe.
+template <class Stub>
+class PowerOfTwoChoicesBalancer
+{
+  private:
+    using Backend = detail::BalancerBackend<Stub>;
+
+  public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    // Gives access to the stub of the picked backend and counts as one in-flight call on it until completed or
+    // destroyed.
+    class Pick
+    {
+      public:
+        Pick(Pick&& other) noexcept
+            : backend(std::exchange(other.backend, nullptr)), weight(other.weight), start(other.start)
+        {
+        }
+
+        Pick(const Pick&) = delete;
+        Pick& operator=(const Pick&) = delete;
+        Pick& operator=(Pick&&) = delete;
+
+        ~Pick() noexcept
+        {
+            if (this->backend)
+            {
+                this->backend->in_flight.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] Stub& stub() const noexcept { return this->backend->stub; }
+
+        Stub* operator->() const noexcept { return &this->backend->stub; }
+
+        [[nodiscard]] const std::string& address() const noexcept { return this->backend->address; }
+
+        // Records the latency of a successful call. A call that did not reach the backend doubles the backend's latency
+        // estimate instead so that backends which fail fast are not mistaken for fast ones.
+        void complete(bool is_success) noexcept
+        {
+            auto* completed_backend = std::exchange(this->backend, nullptr);
+            if (!completed_backend)
+            {
+                return;
+            }
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - this->start)
+                                     .count();
+            if (is_success)
+            {
+                detail::update_ewma(completed_backend->latency_nanoseconds, latency, this->weight);
+            }
+            else
+            {
+                const auto current = completed_backend->latency_nanoseconds.load(std::memory_order_relaxed);
+                detail::update_ewma(completed_backend->latency_nanoseconds, std::max(latency, 2 * current), 1.0);
+            }
+            completed_backend->in_flight.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+      private:
+        friend PowerOfTwoChoicesBalancer;
+
+        Pick(Backend& backend, double weight) noexcept
+            : backend(&backend), weight(weight), start(std::chrono::steady_clock::now())
+        {
+            backend.in_flight.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Backend* backend;
+        double weight;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // weight is the share of a new latency sample in the moving average. Throws std::invalid_argument if addresses is
+    // empty.
+    PowerOfTwoChoicesBalancer(const std::vector<std::string>& addresses,
+                              const std::shared_ptr<grpc::ChannelCredentials>& credentials, double weight = 0.3,
+                              const grpc::ChannelArguments& arguments = {})
+        : weight(weight)
+    {
+        if (addresses.empty())
+        {
+            throw std::invalid_argument{"agrpc::PowerOfTwoChoicesBalancer requires at least one backend"};
+        }
+        this->backends.reserve(addresses.size());
+        for (const auto& address : addresses)
+        {
+            this->backends.emplace_back(
+                std::make_unique<Backend>(address, grpc::CreateCustomChannel(address, credentials, arguments)));
+        }
+    }
+
+    PowerOfTwoChoicesBalancer(const PowerOfTwoChoicesBalancer&) = delete;
+    PowerOfTwoChoicesBalancer(PowerOfTwoChoicesBalancer&&) = delete;
+    PowerOfTwoChoicesBalancer& operator=(const PowerOfTwoChoicesBalancer&) = delete;
+    PowerOfTwoChoicesBalancer& operator=(PowerOfTwoChoicesBalancer&&) = delete;
+
+    [[nodiscard]] Pick pick()
+    {
+        const auto count = this->backends.size();
+        if (count == 1)
+        {
+            return Pick{*this->backends.front(), this->weight};
+        }
+        thread_local std::minstd_rand engine{std::random_device{}()};
+        const auto first = std::uniform_int_distribution<std::size_t>{0, count - 1}(engine);
+        auto second = std::uniform_int_distribution<std::size_t>{0, count - 2}(engine);
+        if (second >= first)
+        {
+            ++second;
+        }
+        auto& first_backend = *this->backends[first];
+        auto& second_backend = *this->backends[second];
+        return Pick{PowerOfTwoChoicesBalancer::cost(first_backend) <= PowerOfTwoChoicesBalancer::cost(second_backend)
+                        ? first_backend
+                        : second_backend,
+                    this->weight};
+    }
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+    // Like agrpc::finish but completes the pick with the call's latency before invoking the completion handler. Only a
+    // failed Finish or a status of UNAVAILABLE counts as a failure of the backend, other error statuses are its answers.
+    template <class Response, class CompletionToken = agrpc::DefaultCompletionToken>
+    static auto finish(Pick pick, grpc::ClientAsyncResponseReader<Response>& reader, Response& response,
+                       grpc::Status& status, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [&](auto completion_handler, Pick pick)
+            {
+                agrpc::finish(reader, response, status,
+                              detail::BalancedFinishHandler<Pick, decltype(completion_handler)>{
+                                  std::move(completion_handler), std::move(pick), status});
+            },
+            token, std::move(pick));
+    }
+#endif
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->backends.size(); }
+
+    [[nodiscard]] std::size_t in_flight(std::size_t index) const noexcept
+    {
+        return this->backends[index]->in_flight.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] Duration latency(std::size_t index) const noexcept
+    {
+        return std::chrono::duration_cast<Duration>(
+            std::chrono::nanoseconds(this->backends[index]->latency_nanoseconds.load(std::memory_order_relaxed)));
+    }
+
+  private:
+    static double cost(const Backend& backend) noexcept
+    {
+        const auto latency = backend.latency_nanoseconds.load(std::memory_order_relaxed);
+        const auto in_flight = backend.in_flight.load(std::memory_order_relaxed);
+        return static_cast<double>(latency) * static_cast<double>(in_flight + 1);
+    }
+
+    double weight;
+    std::vector<std::unique_ptr<Backend>> backends;
+};
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_BALANCER_HPP
@@ -0,0 +1,160 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_BATCHER_HPP
+#define AGRPC_AGRPC_BATCHER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/batcher.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/initiate.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/alarm.h>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Collects individual requests and hands them to batch_function(Batch) as one batch once max_batch_size requests have
+// been submitted or linger has passed since the first request of the batch, whichever comes first. batch_function is
+// expected to issue one batched RPC, fill Batch::responses() in request order and invoke the Batch with the outcome.
+// The linger timer is a grpc::Alarm on the GrpcContext. A linger of zero flushes once per loop turn of the GrpcContext
+// through agrpc::when_idle instead. Must only be used from the thread that runs the GrpcContext and must outlive all of
+// its pending operations.
+template <class Request, class Response>
+class Batcher
+{
+  private:
+    using State = detail::BatchState<Request, Response>;
+
+  public:
+    using Batch = detail::Batch<Request, Response>;
+    using Duration = std::chrono::system_clock::duration;
+
+    Batcher(agrpc::GrpcContext& grpc_context, std::size_t max_batch_size, Duration linger,
+            std::function<void(Batch)> batch_function)
+        : grpc_context(grpc_context),
+          max_batch_size(max_batch_size),
+          linger(linger),
+          batch_function(std::move(batch_function)),
+          state(std::make_unique<State>())
+    {
+    }
+
+    Batcher(const Batcher&) = delete;
+    Batcher(Batcher&&) = delete;
+    Batcher& operator=(const Batcher&) = delete;
+    Batcher& operator=(Batcher&&) = delete;
+
+    ~Batcher() noexcept { this->state->complete(this->grpc_context, detail::InvokeHandler::NO, false); }
+
+    // Completes with true once the batch containing the request has been answered and the matching response has been
+    // moved into response.
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto submit(Request request, Response& response, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [&](auto completion_handler, Request request)
+            {
+                const auto [executor, allocator] = detail::get_associated_executor_and_allocator(completion_handler);
+                auto operation = detail::allocate_operation<false, void(bool)>(
+                    this->grpc_context, std::move(completion_handler), allocator);
+                this->grpc_context.work_started();
+                this->state->requests.emplace_back(std::move(request));
+                this->state->waiters.push_back({operation.get(), &response});
+                operation.release();
+                if (this->state->requests.size() >= this->max_batch_size)
+                {
+                    this->flush();
+                    if (this->is_alarm_armed && this->linger != Duration::zero())
+                    {
+                        this->alarm.Cancel();
+                    }
+                }
+                else if (!this->is_alarm_armed)
+                {
+                    this->arm_alarm();
+                }
+            },
+            token, std::move(request));
+    }
+
+    // Hands the current batch to batch_function without waiting for it to fill up.
+    void flush()
+    {
+        if (this->state->empty())
+        {
+            return;
+        }
+        auto next_state = std::make_unique<State>();
+        next_state->requests.reserve(this->max_batch_size);
+        next_state->waiters.reserve(this->max_batch_size);
+        auto flushed_state = std::exchange(this->state, std::move(next_state));
+        this->batch_function(Batch{this->grpc_context, std::move(flushed_state)});
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->state->requests.size(); }
+
+  private:
+    void arm_alarm()
+    {
+        this->is_alarm_armed = true;
+        if (this->linger == Duration::zero())
+        {
+            agrpc::when_idle(this->grpc_context,
+                             [this]
+                             {
+                                 this->is_alarm_armed = false;
+                                 this->flush();
+                             });
+            return;
+        }
+        agrpc::wait(this->alarm, std::chrono::system_clock::now() + this->linger,
+                    asio::bind_executor(this->grpc_context,
+                                        [this](bool ok)
+                                        {
+                                            this->is_alarm_armed = false;
+                                            if (ok)
+                                            {
+                                                this->flush();
+                                            }
+                                            else if (!this->state->empty())
+                                            {
+                                                this->arm_alarm();
+                                            }
+                                        }));
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    std::size_t max_batch_size;
+    Duration linger;
+    std::function<void(Batch)> batch_function;
+    std::unique_ptr<State> state;
+    grpc::Alarm alarm;
+    bool is_alarm_armed{false};
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_BATCHER_HPP
@@ -0,0 +1,235 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_BROADCASTER_HPP
+#define AGRPC_AGRPC_BROADCASTER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/broadcaster.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/serialization.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/async_stream.h>
+#include <grpcpp/support/byte_buffer.h>
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <utility>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+enum class BroadcastOverflowPolicy
+{
+    DROP_OLDEST,
+    DROP_NEWEST,
+    DISCONNECT
+};
+
+// Fans out messages to many server streams while serializing each message only once. Every subscriber has at most
+// one outstanding write and a bounded queue of messages behind it, the BroadcastOverflowPolicy decides what happens
+// when that queue is full. Must only be used from the thread that runs the GrpcContext.
+template <class Writer = grpc::ServerAsyncWriter<grpc::ByteBuffer>>
+class Broadcaster
+{
+  public:
+    Broadcaster(agrpc::GrpcContext& grpc_context, std::size_t max_queued_messages,
+                agrpc::BroadcastOverflowPolicy overflow_policy = agrpc::BroadcastOverflowPolicy::DROP_OLDEST)
+        : grpc_context(grpc_context), max_queued_messages(max_queued_messages), overflow_policy(overflow_policy)
+    {
+    }
+
+    Broadcaster(const Broadcaster&) = delete;
+    Broadcaster(Broadcaster&&) = delete;
+    Broadcaster& operator=(const Broadcaster&) = delete;
+    Broadcaster& operator=(Broadcaster&&) = delete;
+
+    // Writes and close() capture the Broadcaster, it must not be destroyed while they are pending unless the GrpcContext
+    // has been stopped and will not run them anymore
+    ~Broadcaster() noexcept
+    {
+        assert(this->grpc_context.is_stopped() || !this->has_pending_operations());
+        for (auto& subscriber : this->subscribers)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            subscriber.on_done->complete(detail::InvokeHandler::NO, false, this->grpc_context.get_allocator());
+        }
+    }
+
+    // Completes with true after close() once all queued messages have been written and with false if a write failed
+    // or the subscriber was disconnected. The stream must be finished by the caller afterwards.
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto subscribe(grpc::ServerContext& server_context, Writer& writer, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [this, &server_context, &writer](auto completion_handler)
+            {
+                const auto allocator = asio::get_associated_allocator(completion_handler);
+                auto operation = detail::allocate_operation<false, void(bool)>(
+                    this->grpc_context, std::move(completion_handler), allocator);
+                this->subscribers.push_back(Subscriber{server_context, writer, operation.get()});
+                this->grpc_context.work_started();
+                operation.release();
+            },
+            token);
+    }
+
+    // Returns false if the message cannot be serialized
+    template <class Message>
+    bool publish(const Message& message)
+    {
+        grpc::ByteBuffer buffer;
+        if (!detail::serialize(message, buffer))
+        {
+            return false;
+        }
+        this->publish(buffer);
+        return true;
+    }
+
+    void publish(const grpc::ByteBuffer& buffer)
+    {
+        for (auto it = this->subscribers.begin(); it != this->subscribers.end(); ++it)
+        {
+            this->push(it, buffer);
+        }
+    }
+
+    void close()
+    {
+        for (auto it = this->subscribers.begin(); it != this->subscribers.end(); ++it)
+        {
+            if (std::exchange(it->is_closing, true) || !it->queue.empty())
+            {
+                continue;
+            }
+            detail::create_no_arg_operation<true>(
+                this->grpc_context,
+                [this, it]
+                {
+                    this->complete(it, true);
+                },
+                std::allocator<void>{});
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->subscribers.size(); }
+
+  private:
+    using Subscriber = detail::BroadcastSubscriber<Writer>;
+    using Iterator = typename std::list<Subscriber>::iterator;
+
+    // A subscriber with queued messages has a write in flight, a closing one without has a pending completion
+    [[nodiscard]] bool has_pending_operations() const noexcept
+    {
+        for (const auto& subscriber : this->subscribers)
+        {
+            if (subscriber.is_closing || !subscriber.queue.empty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void push(Iterator it, const grpc::ByteBuffer& buffer)
+    {
+        auto& subscriber = *it;
+        if (subscriber.is_closing || subscriber.is_disconnected)
+        {
+            return;
+        }
+        if (subscriber.queue.empty())
+        {
+            subscriber.queue.push_back(buffer);
+            this->write(it);
+            return;
+        }
+        if (subscriber.queue.size() > this->max_queued_messages)
+        {
+            switch (this->overflow_policy)
+            {
+                case agrpc::BroadcastOverflowPolicy::DROP_OLDEST:
+                    if (subscriber.queue.size() == 1)
+                    {
+                        return;
+                    }
+                    subscriber.queue.erase(std::next(subscriber.queue.begin()));
+                    break;
+                case agrpc::BroadcastOverflowPolicy::DROP_NEWEST:
+                    return;
+                case agrpc::BroadcastOverflowPolicy::DISCONNECT:
+                    subscriber.is_disconnected = true;
+                    subscriber.queue.erase(std::next(subscriber.queue.begin()), subscriber.queue.end());
+                    subscriber.server_context.TryCancel();
+                    return;
+            }
+        }
+        subscriber.queue.push_back(buffer);
+    }
+
+    void write(Iterator it)
+    {
+        agrpc::write(it->writer, it->queue.front(),
+                     asio::bind_executor(this->grpc_context,
+                                         [this, it](bool ok)
+                                         {
+                                             this->on_write(it, ok);
+                                         }));
+    }
+
+    void on_write(Iterator it, bool ok)
+    {
+        auto& subscriber = *it;
+        subscriber.queue.pop_front();
+        if (!ok || subscriber.is_disconnected)
+        {
+            this->complete(it, false);
+        }
+        else if (!subscriber.queue.empty())
+        {
+            this->write(it);
+        }
+        else if (subscriber.is_closing)
+        {
+            this->complete(it, true);
+        }
+    }
+
+    void complete(Iterator it, bool ok)
+    {
+        auto* on_done = it->on_done;
+        this->subscribers.erase(it);
+        detail::WorkFinishedOnExit on_exit{this->grpc_context};
+        on_done->complete(detail::InvokeHandler::YES, ok, this->grpc_context.get_allocator());
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    std::size_t max_queued_messages;
+    agrpc::BroadcastOverflowPolicy overflow_policy;
+    std::list<Subscriber> subscribers;
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_BROADCASTER_HPP
@@ -0,0 +1,146 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_CHANNELPOOL_HPP
+#define AGRPC_AGRPC_CHANNELPOOL_HPP
+
+#include "agrpc/detail/channelPool.hpp"
+
+#include <grpc/impl/codegen/grpc_types.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/support/channel_arguments.h>
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace agrpc
+{
+// Holds several channels to the same target so that calls are spread over multiple HTTP/2 connections. Every channel
+// is created with its own subchannel pool and a distinct channel argument which prevents gRPC from merging them into
+// one connection. Picking and releasing leases is thread-safe.
+template <class Stub>
+class ChannelPool
+{
+  private:
+    using Entry = detail::ChannelPoolEntry<Stub>;
+
+  public:
+    // Gives access to the stub of the picked channel and counts as one in-flight call on it until destroyed.
+    class Lease
+    {
+      public:
+        Lease(Lease&& other) noexcept : entry(std::exchange(other.entry, nullptr)) {}
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        ~Lease() noexcept
+        {
+            if (this->entry)
+            {
+                this->entry->in_flight.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] Stub& stub() const noexcept { return this->entry->stub; }
+
+        [[nodiscard]] grpc::Channel& channel() const noexcept { return *this->entry->channel; }
+
+        Stub* operator->() const noexcept { return &this->entry->stub; }
+
+      private:
+        friend ChannelPool;
+
+        explicit Lease(Entry& entry) noexcept : entry(&entry)
+        {
+            entry.in_flight.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Entry* entry;
+    };
+
+    // Throws std::invalid_argument if size is zero.
+    ChannelPool(const std::string& target, const std::shared_ptr<grpc::ChannelCredentials>& credentials,
+                std::size_t size, const grpc::ChannelArguments& arguments = {})
+        : entries(size)
+    {
+        if (size == 0)
+        {
+            throw std::invalid_argument{"agrpc::ChannelPool requires at least one channel"};
+        }
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            auto channel_arguments = arguments;
+            channel_arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+            channel_arguments.SetInt(detail::CHANNEL_POOL_INDEX_ARG, static_cast<int>(i));
+            this->entries[i] =
+                std::make_unique<Entry>(grpc::CreateCustomChannel(target, credentials, channel_arguments));
+        }
+    }
+
+    ChannelPool(const ChannelPool&) = delete;
+    ChannelPool(ChannelPool&&) = delete;
+    ChannelPool& operator=(const ChannelPool&) = delete;
+    ChannelPool& operator=(ChannelPool&&) = delete;
+
+    // Picks the channel with the fewest in-flight calls.
+    [[nodiscard]] Lease pick() { return this->pick(0, 1); }
+
+    // Picks the channel with the fewest in-flight calls among those whose index modulo partition_count equals
+    // partition. Passing the index of the GrpcContext in a set of GrpcContexts as partition keeps every context on its
+    // own channels. Throws std::invalid_argument if partition_count is zero.
+    [[nodiscard]] Lease pick(std::size_t partition, std::size_t partition_count)
+    {
+        if (partition_count == 0)
+        {
+            throw std::invalid_argument{"agrpc::ChannelPool::pick requires a non-zero partition_count"};
+        }
+        const auto first = partition % partition_count % this->entries.size();
+        Entry* least_loaded = this->entries[first].get();
+        auto least_in_flight = least_loaded->in_flight.load(std::memory_order_relaxed);
+        for (auto i = first + partition_count; i < this->entries.size() && least_in_flight != 0; i += partition_count)
+        {
+            const auto in_flight = this->entries[i]->in_flight.load(std::memory_order_relaxed);
+            if (in_flight < least_in_flight)
+            {
+                least_loaded = this->entries[i].get();
+                least_in_flight = in_flight;
+            }
+        }
+        return Lease{*least_loaded};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->entries.size(); }
+
+    [[nodiscard]] std::size_t in_flight(std::size_t index) const noexcept
+    {
+        return this->entries[index]->in_flight.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::vector<std::unique_ptr<Entry>> entries;
+};
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_CHANNELPOOL_HPP
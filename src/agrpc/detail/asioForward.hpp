@@ -23,6 +23,8 @@
 #include <asio/associated_allocator.hpp>
 #include <asio/associated_executor.hpp>
 #include <asio/async_result.hpp>
+#include <asio/bind_executor.hpp>
+#include <asio/dispatch.hpp>
 #include <asio/execution/allocator.hpp>
 #include <asio/execution/blocking.hpp>
 #include <asio/execution/context.hpp>
@@ -30,6 +32,7 @@
 #include <asio/execution/outstanding_work.hpp>
 #include <asio/execution/relationship.hpp>
 #include <asio/execution_context.hpp>
+#include <asio/post.hpp>
 #include <asio/query.hpp>
 #include <asio/use_awaitable.hpp>
 
@@ -44,6 +47,10 @@
 
 #define AGRPC_ASIO_HAS_CANCELLATION_SLOT
 #endif
+
+#ifndef ASIO_NO_TYPEID
+#define AGRPC_ASIO_HAS_TYPEID
+#endif
 #elif defined(AGRPC_BOOST_ASIO)
 //
 #include <boost/version.hpp>
@@ -52,6 +59,8 @@
 #include <boost/asio/associated_allocator.hpp>
 #include <boost/asio/associated_executor.hpp>
 #include <boost/asio/async_result.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/execution/allocator.hpp>
 #include <boost/asio/execution/blocking.hpp>
 #include <boost/asio/execution/context.hpp>
@@ -59,6 +68,7 @@
 #include <boost/asio/execution/outstanding_work.hpp>
 #include <boost/asio/execution/relationship.hpp>
 #include <boost/asio/execution_context.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/query.hpp>
 #include <boost/asio/use_awaitable.hpp>
 
@@ -73,14 +83,22 @@
 
 #define AGRPC_ASIO_HAS_CANCELLATION_SLOT
 #endif
+
+#ifndef BOOST_ASIO_NO_TYPEID
+#define AGRPC_ASIO_HAS_TYPEID
+#endif
 #endif
 
 #ifdef AGRPC_UNIFEX
 #include <unifex/config.hpp>
+#include <unifex/get_stop_token.hpp>
 #include <unifex/receiver_concepts.hpp>
 #include <unifex/scheduler_concepts.hpp>
 #include <unifex/sender_concepts.hpp>
+#include <unifex/stop_token_concepts.hpp>
 #include <unifex/tag_invoke.hpp>
+#elif defined(AGRPC_STDEXEC)
+#include <stdexec/execution.hpp>
 #endif
 
 namespace agrpc
@@ -91,6 +109,18 @@ namespace asio = ::asio;
 namespace asio = ::boost::asio;
 #endif
 
+#ifdef AGRPC_UNIFEX
+namespace detail
+{
+namespace exec = ::unifex;
+}
+#elif defined(AGRPC_STDEXEC)
+namespace detail
+{
+namespace exec = ::stdexec;
+}
+#endif
+
 #if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
 namespace detail
 {
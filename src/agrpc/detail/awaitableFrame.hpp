@@ -0,0 +1,104 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_AWAITABLEFRAME_HPP
+#define AGRPC_DETAIL_AWAITABLEFRAME_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/frameCache.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+#include <coroutine>
+
+namespace agrpc
+{
+template <class Allocator, std::uint32_t Options>
+class BasicGrpcExecutor;
+
+namespace detail
+{
+template <class T, class Executor>
+class RecyclingAwaitableFrame;
+
+// asio::awaitable can only be awaited by coroutines whose promise is exactly asio::detail::awaitable_frame. Asio
+// keeps treating the handle as one of an awaitable_frame, which is why RecyclingAwaitableFrame must not add any data
+// members. Checked against the awaitable_frame of Asio 1.18.0 (Boost 1.74).
+template <class T, class Executor>
+struct RecyclingAwaitableAwaiter
+{
+    asio::awaitable<T, Executor> awaitable;
+
+    bool await_ready() const noexcept { return this->awaitable.await_ready(); }
+
+    template <class U>
+    void await_suspend(std::coroutine_handle<detail::RecyclingAwaitableFrame<U, Executor>> handle)
+    {
+        static_assert(sizeof(detail::RecyclingAwaitableFrame<U, Executor>) ==
+                              sizeof(asio::detail::awaitable_frame<U, Executor>) &&
+                          alignof(detail::RecyclingAwaitableFrame<U, Executor>) ==
+                              alignof(asio::detail::awaitable_frame<U, Executor>),
+                      "RecyclingAwaitableFrame must have the layout of asio::detail::awaitable_frame");
+        this->awaitable.await_suspend(
+            std::coroutine_handle<asio::detail::awaitable_frame<U, Executor>>::from_address(handle.address()));
+    }
+
+    T await_resume() { return this->awaitable.await_resume(); }
+};
+
+// Promise of asio::awaitable<T, GrpcExecutor>. Asio recycles only one frame per thread, this promise takes frames
+// from the FrameCache of the GrpcContext that is running in this thread instead. That includes the frames that
+// asio::co_spawn and asio::use_awaitable create for their own bookkeeping.
+template <class T, class Executor>
+class RecyclingAwaitableFrame : public asio::detail::awaitable_frame<T, Executor>
+{
+  public:
+    using asio::detail::awaitable_frame<T, Executor>::await_transform;
+
+    template <class U>
+    auto await_transform(asio::awaitable<U, Executor> awaitable) const
+    {
+        return detail::RecyclingAwaitableAwaiter<U, Executor>{std::move(awaitable)};
+    }
+
+    static void* operator new(std::size_t size)
+    {
+        return detail::FrameCache::allocate(detail::GrpcContextImplementation::frame_cache_of_this_thread(), size);
+    }
+
+    static void operator delete(void* frame, std::size_t size) noexcept
+    {
+        detail::FrameCache::deallocate(detail::GrpcContextImplementation::frame_cache_of_this_thread(), frame, size);
+    }
+};
+}  // namespace detail
+}  // namespace agrpc
+
+namespace std
+{
+template <class T, class Allocator, std::uint32_t Options, class... Args>
+struct coroutine_traits<agrpc::asio::awaitable<T, agrpc::BasicGrpcExecutor<Allocator, Options>>, Args...>
+{
+    using promise_type = agrpc::detail::RecyclingAwaitableFrame<T, agrpc::BasicGrpcExecutor<Allocator, Options>>;
+};
+}  // namespace std
+#endif
+#endif
+
+#endif  // AGRPC_DETAIL_AWAITABLEFRAME_HPP
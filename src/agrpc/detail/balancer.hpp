@@ -0,0 +1,94 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_BALANCER_HPP
+#define AGRPC_DETAIL_BALANCER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+
+#include <grpcpp/channel.h>
+#include <grpcpp/support/status.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace agrpc::detail
+{
+template <class Stub>
+struct BalancerBackend
+{
+    std::string address;
+    std::shared_ptr<grpc::Channel> channel;
+    Stub stub;
+    std::atomic_size_t in_flight{};
+
+    // Zero until the first call completed
+    std::atomic<std::int64_t> latency_nanoseconds{};
+
+    BalancerBackend(std::string address, std::shared_ptr<grpc::Channel> channel)
+        : address(std::move(address)), channel(std::move(channel)), stub(this->channel)
+    {
+    }
+};
+
+inline void update_ewma(std::atomic<std::int64_t>& average, std::int64_t sample, double weight) noexcept
+{
+    auto current = average.load(std::memory_order_relaxed);
+    std::int64_t next;
+    do
+    {
+        next = current == 0 ? sample
+                            : static_cast<std::int64_t>(weight * static_cast<double>(sample) +
+                                                        (1.0 - weight) * static_cast<double>(current));
+    } while (!average.compare_exchange_weak(current, std::max(next, std::int64_t{1}), std::memory_order_relaxed));
+}
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+template <class Pick, class CompletionHandler>
+struct BalancedFinishHandler
+{
+    using executor_type = asio::associated_executor_t<CompletionHandler>;
+    using allocator_type = asio::associated_allocator_t<CompletionHandler>;
+
+    CompletionHandler completion_handler;
+    Pick pick;
+    const grpc::Status& status;
+
+    void operator()(bool ok)
+    {
+        this->pick.complete(ok && this->status.error_code() != grpc::StatusCode::UNAVAILABLE);
+        std::move(this->completion_handler)(ok);
+    }
+
+    [[nodiscard]] executor_type get_executor() const noexcept
+    {
+        return asio::get_associated_executor(this->completion_handler);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return asio::get_associated_allocator(this->completion_handler);
+    }
+};
+#endif
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_BALANCER_HPP
@@ -0,0 +1,101 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_BATCHER_HPP
+#define AGRPC_DETAIL_BATCHER_HPP
+
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace agrpc::detail
+{
+template <class Response>
+struct BatchWaiter
+{
+    detail::TypeErasedGrpcTagOperation* operation;
+    Response* response;
+};
+
+template <class Request, class Response>
+struct BatchState
+{
+    std::vector<Request> requests;
+    std::vector<Response> responses;
+    std::vector<detail::BatchWaiter<Response>> waiters;
+
+    [[nodiscard]] bool empty() const noexcept { return this->requests.empty(); }
+
+    void complete(agrpc::GrpcContext& grpc_context, detail::InvokeHandler invoke_handler, bool ok)
+    {
+        for (std::size_t i = 0; i < this->waiters.size(); ++i)
+        {
+            const auto& waiter = this->waiters[i];
+            if (ok)
+            {
+                *waiter.response = std::move(this->responses[i]);
+            }
+            detail::WorkFinishedOnExit on_exit{grpc_context};
+            waiter.operation->complete(invoke_handler, ok, grpc_context.get_allocator());
+        }
+    }
+};
+
+// Owns one flushed batch and may be invoked once, as an rvalue. Invoking it moves responses[i] into the i-th caller's response. A batch that is destroyed
+// without being invoked, or whose number of responses does not match the number of requests, completes every caller
+// with false.
+template <class Request, class Response>
+class Batch
+{
+  public:
+    Batch(agrpc::GrpcContext& grpc_context, std::unique_ptr<detail::BatchState<Request, Response>> state) noexcept
+        : grpc_context(&grpc_context), state(std::move(state))
+    {
+    }
+
+    Batch(Batch&&) noexcept = default;
+    Batch& operator=(Batch&&) = delete;
+
+    ~Batch() noexcept
+    {
+        if (this->state)
+        {
+            std::move(*this)(false);
+        }
+    }
+
+    [[nodiscard]] std::vector<Request>& requests() noexcept { return this->state->requests; }
+
+    [[nodiscard]] std::vector<Response>& responses() noexcept { return this->state->responses; }
+
+    void operator()(bool ok) &&
+    {
+        const auto completed_state = std::move(this->state);
+        completed_state->complete(*this->grpc_context, detail::InvokeHandler::YES,
+                                  ok && completed_state->responses.size() == completed_state->waiters.size());
+    }
+
+  private:
+    agrpc::GrpcContext* grpc_context;
+    std::unique_ptr<detail::BatchState<Request, Response>> state;
+};
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_BATCHER_HPP
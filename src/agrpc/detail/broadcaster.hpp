@@ -0,0 +1,40 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_BROADCASTER_HPP
+#define AGRPC_DETAIL_BROADCASTER_HPP
+
+#include "agrpc/detail/typeErasedOperation.hpp"
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/byte_buffer.h>
+
+#include <deque>
+
+namespace agrpc::detail
+{
+template <class Writer>
+struct BroadcastSubscriber
+{
+    grpc::ServerContext& server_context;
+    Writer& writer;
+    detail::TypeErasedGrpcTagOperation* on_done;
+    std::deque<grpc::ByteBuffer> queue{};
+    bool is_closing{false};
+    bool is_disconnected{false};
+};
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_BROADCASTER_HPP
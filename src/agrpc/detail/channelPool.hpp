@@ -0,0 +1,42 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_CHANNELPOOL_HPP
+#define AGRPC_DETAIL_CHANNELPOOL_HPP
+
+#include <grpcpp/channel.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace agrpc::detail
+{
+inline constexpr const char* CHANNEL_POOL_INDEX_ARG = "agrpc.channel_pool_index";
+
+template <class Stub>
+struct ChannelPoolEntry
+{
+    std::shared_ptr<grpc::Channel> channel;
+    Stub stub;
+    std::atomic_size_t in_flight{};
+
+    explicit ChannelPoolEntry(std::shared_ptr<grpc::Channel> channel) : channel(std::move(channel)), stub(this->channel)
+    {
+    }
+};
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_CHANNELPOOL_HPP
@@ -0,0 +1,75 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_DUPLEX_HPP
+#define AGRPC_DETAIL_DUPLEX_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/async_stream.h>
+#include <grpcpp/support/status.h>
+
+#include <utility>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc::detail
+{
+template <class ReaderWriter>
+struct DuplexTraits;
+
+template <class Request, class Response>
+struct DuplexTraits<grpc::ClientAsyncReaderWriter<Request, Response>>
+{
+    static constexpr bool IS_CLIENT = true;
+
+    using Context = grpc::ClientContext;
+    using StatusReference = grpc::Status&;
+    using StatusStorage = grpc::Status*;
+
+    static StatusStorage store(grpc::Status& status) noexcept { return &status; }
+
+    template <class CompletionToken>
+    static void finish(grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, StatusStorage status,
+                       CompletionToken token)
+    {
+        agrpc::finish(reader_writer, *status, std::move(token));
+    }
+};
+
+template <class Response, class Request>
+struct DuplexTraits<grpc::ServerAsyncReaderWriter<Response, Request>>
+{
+    static constexpr bool IS_CLIENT = false;
+
+    using Context = grpc::ServerContext;
+    using StatusReference = const grpc::Status&;
+    using StatusStorage = grpc::Status;
+
+    static StatusStorage store(const grpc::Status& status) { return status; }
+
+    template <class CompletionToken>
+    static void finish(grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const StatusStorage& status,
+                       CompletionToken token)
+    {
+        agrpc::finish(reader_writer, status, std::move(token));
+    }
+};
+}  // namespace agrpc::detail
+#endif
+
+#endif  // AGRPC_DETAIL_DUPLEX_HPP
@@ -0,0 +1,359 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_EXECUTORHOP_HPP
+#define AGRPC_DETAIL_EXECUTORHOP_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/attributes.hpp"
+#include "agrpc/detail/completionHandlerWithPayload.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/intrusiveQueue.hpp"
+#include "agrpc/detail/memory.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/detail/utility.hpp"
+#include "agrpc/grpcContext.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc
+{
+template <class Allocator, std::uint32_t Options>
+class BasicGrpcExecutor;
+
+namespace detail
+{
+template <class Executor>
+inline constexpr bool IS_GRPC_EXECUTOR_V = false;
+
+template <class Allocator, std::uint32_t Options>
+inline constexpr bool IS_GRPC_EXECUTOR_V<agrpc::BasicGrpcExecutor<Allocator, Options>> = true;
+
+// Polymorphic executors like asio::any_io_executor
+template <class Executor, class = void>
+inline constexpr bool HAS_TARGET_V = false;
+
+template <class Executor>
+inline constexpr bool HAS_TARGET_V<Executor, decltype((void)std::declval<const Executor&>()
+                                                          .template target<agrpc::GrpcContext::executor_type>())> =
+    true;
+
+template <class Executor>
+inline constexpr bool MAY_BE_GRPC_EXECUTOR_V = detail::IS_GRPC_EXECUTOR_V<Executor> || detail::HAS_TARGET_V<Executor>;
+
+template <class T>
+inline constexpr char TYPE_ID{};
+
+// Handlers whose associated executor is a GrpcExecutor are invoked directly by the GrpcContext
+template <class Executor>
+bool is_grpc_executor([[maybe_unused]] const Executor& executor) noexcept
+{
+    if constexpr (detail::IS_GRPC_EXECUTOR_V<Executor>)
+    {
+        return true;
+    }
+    else if constexpr (detail::HAS_TARGET_V<Executor>)
+    {
+#ifdef AGRPC_ASIO_HAS_TYPEID
+        // target() does not check the type of the target executor in older versions of Asio
+        return executor.target_type() == typeid(agrpc::GrpcContext::executor_type);
+#else
+        return executor.template target<agrpc::GrpcContext::executor_type>() != nullptr;
+#endif
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// Returns nullptr if the executor does not belong to a GrpcContext
+template <class Executor>
+agrpc::GrpcContext* grpc_context_of(const Executor& executor)
+{
+    auto& context = asio::query(executor, asio::execution::context);
+    using Context = std::remove_reference_t<decltype(context)>;
+    if constexpr (std::is_convertible_v<Context*, agrpc::GrpcContext*>)
+    {
+        return std::addressof(context);
+    }
+    else if constexpr (std::is_base_of_v<Context, agrpc::GrpcContext>)
+    {
+        // The execution_context is not polymorphic, it can only be compared to the GrpcContext of this thread
+        auto* grpc_context = detail::GrpcContextImplementation::hop_origin_of_this_thread();
+        if (grpc_context != nullptr && static_cast<Context*>(grpc_context) == std::addressof(context))
+        {
+            return grpc_context;
+        }
+        return nullptr;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+// Executors that do not belong to a GrpcContext, like the one of an io_context, use the GrpcContext that runs in this
+// thread or whose completions are being invoked in this thread. The completion may still be dequeued by another
+// GrpcContext, e.g. for RPCs that were started on it, ExecutorHopOperation accounts for that.
+inline agrpc::GrpcContext& hop_grpc_context()
+{
+    auto* grpc_context = detail::GrpcContextImplementation::hop_origin_of_this_thread();
+    if (grpc_context == nullptr) AGRPC_UNLIKELY
+        {
+            throw std::logic_error{
+                "Completion handlers whose associated executor does not belong to a GrpcContext can only be used from "
+                "a thread that runs a GrpcContext or from such a handler"};
+        }
+    return *grpc_context;
+}
+
+template <class CompletionHandler, class Arg>
+struct BoundCompletionHandler
+{
+    using executor_type = asio::associated_executor_t<CompletionHandler>;
+    using allocator_type = asio::associated_allocator_t<CompletionHandler>;
+
+    CompletionHandler completion_handler;
+    Arg arg;
+
+    void operator()() { std::move(this->completion_handler)(std::move(this->arg)); }
+
+    [[nodiscard]] executor_type get_executor() const noexcept
+    {
+        return asio::get_associated_executor(this->completion_handler);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return asio::get_associated_allocator(this->completion_handler);
+    }
+};
+
+// Completion handler of operations whose handler is associated with an executor of the GrpcContext other than a
+// GrpcExecutor, like a strand
+template <class CompletionHandler>
+struct DispatchToAssociatedExecutor
+{
+    CompletionHandler completion_handler;
+
+    template <class Arg>
+    void operator()(Arg&& arg) &&
+    {
+        asio::dispatch(detail::BoundCompletionHandler<CompletionHandler, detail::RemoveCvrefT<Arg>>{
+            std::move(this->completion_handler), std::forward<Arg>(arg)});
+    }
+};
+
+template <class CompletionHandler>
+auto dispatch_to_associated_executor(CompletionHandler completion_handler)
+{
+    return detail::DispatchToAssociatedExecutor<CompletionHandler>{std::move(completion_handler)};
+}
+
+// The payload is filled in by the initiating function through the operation's handler()
+template <class Payload, class CompletionHandler>
+auto dispatch_to_associated_executor(detail::CompletionHandlerWithPayload<Payload, CompletionHandler> completion_handler)
+{
+    return detail::CompletionHandlerWithPayload<Payload, detail::DispatchToAssociatedExecutor<CompletionHandler>>{
+        detail::DispatchToAssociatedExecutor<CompletionHandler>{std::move(completion_handler.completion_handler)},
+        std::move(completion_handler.payload)};
+}
+
+class ExecutorHopFunction
+{
+  public:
+    ExecutorHopFunction(agrpc::GrpcContext& grpc_context,
+                        detail::IntrusiveQueue<detail::TypeErasedHopOperation>&& operations) noexcept
+        : grpc_context(&grpc_context), operations(std::move(operations))
+    {
+    }
+
+    ExecutorHopFunction(agrpc::GrpcContext& grpc_context, detail::TypeErasedHopOperation* operation) noexcept
+        : grpc_context(&grpc_context)
+    {
+        this->operations.push_back(operation);
+    }
+
+    ExecutorHopFunction(ExecutorHopFunction&&) = default;
+
+    ExecutorHopFunction& operator=(ExecutorHopFunction&&) = default;
+
+    ~ExecutorHopFunction()
+    {
+        while (!this->operations.empty())
+        {
+            this->operations.pop_front()->complete(detail::InvokeHandler::NO);
+        }
+    }
+
+    void operator()()
+    {
+        // Operations that the handlers initiate find their GrpcContext through the hop origin
+        detail::ScopeGuard on_exit{
+            [old_origin = detail::GrpcContextImplementation::set_thread_local_hop_origin(this->grpc_context)]
+            {
+                detail::GrpcContextImplementation::set_thread_local_hop_origin(old_origin);
+            }};
+        while (!this->operations.empty())
+        {
+            this->operations.pop_front()->complete(detail::InvokeHandler::YES);
+        }
+    }
+
+  private:
+    agrpc::GrpcContext* grpc_context;
+    detail::IntrusiveQueue<detail::TypeErasedHopOperation> operations;
+};
+
+template <class Executor>
+class ExecutorHopBatch : public detail::TypeErasedExecutorHopBatch
+{
+  public:
+    ExecutorHopBatch(agrpc::GrpcContext& grpc_context, const Executor& executor)
+        : detail::TypeErasedExecutorHopBatch(&ExecutorHopBatch::do_complete, &detail::TYPE_ID<Executor>),
+          grpc_context(grpc_context),
+          executor(executor)
+    {
+    }
+
+    [[nodiscard]] const Executor& get_executor() const noexcept { return this->executor; }
+
+  private:
+    static void do_complete(detail::TypeErasedExecutorHopBatch* op, detail::InvokeHandler invoke_handler,
+                            detail::GrpcContextLocalAllocator allocator)
+    {
+        auto* self = static_cast<ExecutorHopBatch*>(op);
+        detail::RebindAllocatedPointer<ExecutorHopBatch, detail::GrpcContextLocalAllocator> ptr{self, allocator};
+        detail::ExecutorHopFunction function{self->grpc_context, std::move(self->operations)};
+        if (detail::InvokeHandler::YES == invoke_handler)
+        {
+            auto local_executor{std::move(self->executor)};
+            ptr.reset();
+            asio::post(local_executor, std::move(function));
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    Executor executor;
+};
+
+// All completions that hop to the same executor during one iteration of the GrpcContext are posted to it at once
+template <class Executor>
+void add_executor_hop(agrpc::GrpcContext& grpc_context, const Executor& executor, detail::TypeErasedHopOperation* op)
+{
+    for (auto* batch = detail::GrpcContextImplementation::executor_hop_batches(grpc_context); batch != nullptr;
+         batch = batch->next)
+    {
+        if (batch->executor_type == &detail::TYPE_ID<Executor> &&
+            static_cast<detail::ExecutorHopBatch<Executor>*>(batch)->get_executor() == executor)
+        {
+            batch->operations.push_back(op);
+            return;
+        }
+    }
+    auto batch = detail::allocate<detail::ExecutorHopBatch<Executor>>(grpc_context.get_allocator(), grpc_context,
+                                                                      executor);
+    batch->operations.push_back(op);
+    detail::GrpcContextImplementation::add_executor_hop_batch(grpc_context, batch.get());
+    batch.release();
+}
+
+// Completion queue tag of operations whose completion handler is associated with an executor other than a
+// GrpcExecutor. It is allocated with the handler's allocator because it is destroyed on that executor. The
+// TypeErasedGrpcTagOperation base must come first, the operation is handed to gRPC as a void*.
+template <class Handler, class Allocator>
+class ExecutorHopOperation : public detail::TypeErasedGrpcTagOperation, public detail::TypeErasedHopOperation
+{
+  private:
+    using WorkExecutor = detail::RemoveCvrefT<decltype(asio::prefer(
+        asio::get_associated_executor(std::declval<Handler&>()), asio::execution::outstanding_work.tracked))>;
+
+  public:
+    template <class H>
+    ExecutorHopOperation(agrpc::GrpcContext& grpc_context, H&& handler, Allocator allocator)
+        : detail::TypeErasedGrpcTagOperation(&ExecutorHopOperation::do_complete),
+          detail::TypeErasedHopOperation(&ExecutorHopOperation::do_hop),
+          grpc_context(grpc_context),
+          work_executor(
+              asio::prefer(asio::get_associated_executor(handler), asio::execution::outstanding_work.tracked)),
+          impl(std::forward<H>(handler), std::move(allocator))
+    {
+    }
+
+    [[nodiscard]] constexpr decltype(auto) handler() noexcept { return impl.first(); }
+
+    [[nodiscard]] constexpr decltype(auto) get_allocator() noexcept { return impl.second(); }
+
+  private:
+    static void do_complete(detail::TypeErasedGrpcTagOperation* op, detail::InvokeHandler invoke_handler, bool ok,
+                            detail::GrpcContextLocalAllocator)
+    {
+        auto* self = static_cast<ExecutorHopOperation*>(op);
+        detail::RebindAllocatedPointer<ExecutorHopOperation, Allocator> ptr{self, self->get_allocator()};
+        if (detail::InvokeHandler::YES == invoke_handler)
+        {
+            self->ok = ok;
+            auto& grpc_context = *detail::GrpcContextImplementation::hop_origin_of_this_thread();
+            if (&grpc_context != &self->grpc_context)
+            {
+                // The tag was dequeued by the GrpcContext that the RPC belongs to, it takes over the outstanding work
+                grpc_context.work_started();
+                self->grpc_context.work_finished();
+            }
+            if (detail::grpc_context_of(self->work_executor) == &grpc_context)
+            {
+                // Executors of this GrpcContext, like strands, may invoke the handler right away
+                auto executor{self->work_executor};
+                detail::ExecutorHopFunction function{grpc_context, self};
+                ptr.release();
+                asio::dispatch(executor, std::move(function));
+            }
+            else
+            {
+                detail::add_executor_hop(grpc_context, self->work_executor, self);
+                ptr.release();
+            }
+        }
+    }
+
+    static void do_hop(detail::TypeErasedHopOperation* op, detail::InvokeHandler invoke_handler)
+    {
+        auto* self = static_cast<ExecutorHopOperation*>(op);
+        detail::RebindAllocatedPointer<ExecutorHopOperation, Allocator> ptr{self, self->get_allocator()};
+        if (detail::InvokeHandler::YES == invoke_handler)
+        {
+            auto local_handler{std::move(self->handler())};
+            const auto local_ok = self->ok;
+            ptr.reset();
+            std::move(local_handler)(local_ok);
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    WorkExecutor work_executor;
+    detail::CompressedPair<Handler, Allocator> impl;
+    bool ok{};
+};
+}  // namespace detail
+}  // namespace agrpc
+#endif
+
+#endif  // AGRPC_DETAIL_EXECUTORHOP_HPP
@@ -0,0 +1,117 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_FRAMECACHE_HPP
+#define AGRPC_DETAIL_FRAMECACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace agrpc::detail
+{
+// Free lists of coroutine frames, one per power-of-two size class. Each list holds at most `depth` frames. Frames
+// are always obtained from operator new with the size of their class, so a frame may be returned to any cache.
+class FrameCache
+{
+  public:
+    static constexpr std::size_t DEFAULT_DEPTH = 16;
+
+    explicit FrameCache(std::size_t depth = DEFAULT_DEPTH) noexcept : depth(depth) {}
+
+    FrameCache(const FrameCache&) = delete;
+
+    FrameCache& operator=(const FrameCache&) = delete;
+
+    ~FrameCache()
+    {
+        for (auto& bucket : this->buckets)
+        {
+            while (bucket.head != nullptr)
+            {
+                ::operator delete(std::exchange(bucket.head, bucket.head->next));
+            }
+        }
+    }
+
+    [[nodiscard]] static void* allocate(detail::FrameCache* cache, std::size_t size)
+    {
+        const auto index = FrameCache::size_class(size);
+        if (index == CLASS_COUNT)
+        {
+            return ::operator new(size);
+        }
+        if (cache != nullptr)
+        {
+            auto& bucket = cache->buckets[index];
+            if (bucket.head != nullptr)
+            {
+                --bucket.count;
+                return std::exchange(bucket.head, bucket.head->next);
+            }
+        }
+        return ::operator new(FrameCache::class_size(index));
+    }
+
+    static void deallocate(detail::FrameCache* cache, void* frame, std::size_t size) noexcept
+    {
+        const auto index = FrameCache::size_class(size);
+        if (index != CLASS_COUNT && cache != nullptr)
+        {
+            auto& bucket = cache->buckets[index];
+            if (bucket.count < cache->depth)
+            {
+                ++bucket.count;
+                bucket.head = ::new (frame) FreeFrame{bucket.head};
+                return;
+            }
+        }
+        ::operator delete(frame);
+    }
+
+  private:
+    static constexpr std::size_t MIN_CLASS_SIZE = 64;
+    static constexpr std::size_t CLASS_COUNT = 8;
+
+    struct FreeFrame
+    {
+        FreeFrame* next;
+    };
+
+    struct Bucket
+    {
+        FreeFrame* head{};
+        std::size_t count{};
+    };
+
+    static constexpr std::size_t class_size(std::size_t index) noexcept { return MIN_CLASS_SIZE << index; }
+
+    // Returns CLASS_COUNT for frames that are too large to be cached
+    static constexpr std::size_t size_class(std::size_t size) noexcept
+    {
+        std::size_t index{};
+        while (index < CLASS_COUNT && FrameCache::class_size(index) < size)
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    std::array<Bucket, CLASS_COUNT> buckets{};
+    std::size_t depth;
+};
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_FRAMECACHE_HPP
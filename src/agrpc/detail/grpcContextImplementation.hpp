@@ -15,10 +15,15 @@
 #ifndef AGRPC_DETAIL_GRPCCONTEXTIMPLEMENTATION_HPP
 #define AGRPC_DETAIL_GRPCCONTEXTIMPLEMENTATION_HPP
 
+#include "agrpc/detail/frameCache.hpp"
 #include "agrpc/detail/grpcCompletionQueueEvent.hpp"
+#include "agrpc/detail/grpcContext.hpp"
 #include "agrpc/detail/typeErasedOperation.hpp"
 #include "agrpc/detail/utility.hpp"
 
+#include <grpc/support/time.h>
+#include <grpcpp/completion_queue.h>
+
 namespace agrpc
 {
 class GrpcContext;
@@ -50,17 +55,45 @@ struct GrpcContextImplementation
 
     static void add_local_operation(agrpc::GrpcContext& grpc_context, detail::TypeErasedNoArgOperation* op);
 
-    static bool get_next_event(agrpc::GrpcContext& grpc_context, detail::GrpcCompletionQueueEvent& event);
+    static void add_idle_operation(agrpc::GrpcContext& grpc_context, detail::TypeErasedNoArgOperation* op);
+
+    static grpc::CompletionQueue::NextStatus get_next_event(agrpc::GrpcContext& grpc_context,
+                                                            detail::GrpcCompletionQueueEvent& event,
+                                                            const ::gpr_timespec& deadline);
 
     [[nodiscard]] static bool running_in_this_thread(const agrpc::GrpcContext& grpc_context) noexcept;
 
+    // Returns nullptr if no GrpcContext is running in this thread
+    [[nodiscard]] static detail::GrpcContextLocalMemoryResource* local_resource_of_this_thread() noexcept;
+
+    // Returns nullptr if no GrpcContext is running in this thread
+    [[nodiscard]] static detail::FrameCache* frame_cache_of_this_thread() noexcept;
+
     static const agrpc::GrpcContext* set_thread_local_grpc_context(const agrpc::GrpcContext* grpc_context) noexcept;
 
+    // Returns the GrpcContext that is running in this thread or whose completions this thread is currently invoking
+    // on another executor, nullptr if there is none
+    [[nodiscard]] static agrpc::GrpcContext* hop_origin_of_this_thread() noexcept;
+
+    static agrpc::GrpcContext* set_thread_local_hop_origin(agrpc::GrpcContext* grpc_context) noexcept;
+
+    [[nodiscard]] static detail::TypeErasedExecutorHopBatch* executor_hop_batches(
+        agrpc::GrpcContext& grpc_context) noexcept;
+
+    static void add_executor_hop_batch(agrpc::GrpcContext& grpc_context,
+                                       detail::TypeErasedExecutorHopBatch* batch) noexcept;
+
+    template <detail::InvokeHandler Invoke>
+    static void complete_executor_hops(agrpc::GrpcContext& grpc_context);
+
     static void move_remote_work_to_local_queue(agrpc::GrpcContext& grpc_context) noexcept;
 
     template <detail::InvokeHandler Invoke>
     static void process_local_queue(agrpc::GrpcContext& grpc_context);
 
+    template <detail::InvokeHandler Invoke>
+    static void process_idle_queue(agrpc::GrpcContext& grpc_context);
+
     template <detail::InvokeHandler Invoke, class IsStoppedPredicate>
     static bool process_work(agrpc::GrpcContext& grpc_context, IsStoppedPredicate is_stopped_predicate);
 };
@@ -22,17 +22,23 @@
 
 #include <cstdint>
 #include <limits>
+#include <utility>
 
 namespace agrpc::detail
 {
 inline thread_local const agrpc::GrpcContext* thread_local_grpc_context{};
 
+inline thread_local agrpc::GrpcContext* thread_local_hop_origin{};
+
+inline constexpr ::gpr_timespec TIME_ZERO{std::numeric_limits<std::int64_t>::min(), 0, ::GPR_CLOCK_MONOTONIC};
+
+inline constexpr ::gpr_timespec INFINITE_FUTURE{std::numeric_limits<std::int64_t>::max(), 0, ::GPR_CLOCK_MONOTONIC};
+
 inline void WorkFinishedOnExitFunctor::operator()() const noexcept { grpc_context.work_finished(); }
 
 inline void GrpcContextImplementation::trigger_work_alarm(agrpc::GrpcContext& grpc_context)
 {
-    static constexpr ::gpr_timespec TIME_ZERO{std::numeric_limits<std::int64_t>::min(), 0, ::GPR_CLOCK_MONOTONIC};
-    grpc_context.work_alarm.Set(grpc_context.completion_queue.get(), TIME_ZERO,
+    grpc_context.work_alarm.Set(grpc_context.completion_queue.get(), detail::TIME_ZERO,
                                 detail::GrpcContextImplementation::HAS_REMOTE_WORK_TAG);
 }
 
@@ -53,12 +59,17 @@ inline void GrpcContextImplementation::add_local_operation(agrpc::GrpcContext& g
     grpc_context.local_work_queue.push_back(op);
 }
 
-inline bool GrpcContextImplementation::get_next_event(agrpc::GrpcContext& grpc_context,
-                                                      detail::GrpcCompletionQueueEvent& event)
+inline void GrpcContextImplementation::add_idle_operation(agrpc::GrpcContext& grpc_context,
+                                                          detail::TypeErasedNoArgOperation* op)
+{
+    grpc_context.work_started();
+    grpc_context.idle_work_queue.push_back(op);
+}
+
+inline grpc::CompletionQueue::NextStatus GrpcContextImplementation::get_next_event(
+    agrpc::GrpcContext& grpc_context, detail::GrpcCompletionQueueEvent& event, const ::gpr_timespec& deadline)
 {
-    static constexpr ::gpr_timespec INFINITE_FUTURE{std::numeric_limits<std::int64_t>::max(), 0, ::GPR_CLOCK_MONOTONIC};
-    return grpc_context.get_completion_queue()->AsyncNext(&event.tag, &event.ok, INFINITE_FUTURE) !=
-           grpc::CompletionQueue::SHUTDOWN;
+    return grpc_context.get_completion_queue()->AsyncNext(&event.tag, &event.ok, deadline);
 }
 
 inline bool GrpcContextImplementation::running_in_this_thread(const agrpc::GrpcContext& grpc_context) noexcept
@@ -66,12 +77,70 @@ inline bool GrpcContextImplementation::running_in_this_thread(const agrpc::GrpcC
     return std::addressof(grpc_context) == detail::thread_local_grpc_context;
 }
 
+inline detail::GrpcContextLocalMemoryResource* GrpcContextImplementation::local_resource_of_this_thread() noexcept
+{
+    if (detail::thread_local_grpc_context == nullptr)
+    {
+        return nullptr;
+    }
+    return &const_cast<agrpc::GrpcContext*>(detail::thread_local_grpc_context)->local_resource;
+}
+
+inline detail::FrameCache* GrpcContextImplementation::frame_cache_of_this_thread() noexcept
+{
+    if (detail::thread_local_grpc_context == nullptr)
+    {
+        return nullptr;
+    }
+    return &const_cast<agrpc::GrpcContext*>(detail::thread_local_grpc_context)->frame_cache;
+}
+
 inline const agrpc::GrpcContext* GrpcContextImplementation::set_thread_local_grpc_context(
     const agrpc::GrpcContext* grpc_context) noexcept
 {
     return std::exchange(detail::thread_local_grpc_context, grpc_context);
 }
 
+inline agrpc::GrpcContext* GrpcContextImplementation::hop_origin_of_this_thread() noexcept
+{
+    if (detail::thread_local_grpc_context != nullptr)
+    {
+        return const_cast<agrpc::GrpcContext*>(detail::thread_local_grpc_context);
+    }
+    return detail::thread_local_hop_origin;
+}
+
+inline agrpc::GrpcContext* GrpcContextImplementation::set_thread_local_hop_origin(
+    agrpc::GrpcContext* grpc_context) noexcept
+{
+    return std::exchange(detail::thread_local_hop_origin, grpc_context);
+}
+
+inline detail::TypeErasedExecutorHopBatch* GrpcContextImplementation::executor_hop_batches(
+    agrpc::GrpcContext& grpc_context) noexcept
+{
+    return grpc_context.executor_hop_batches;
+}
+
+inline void GrpcContextImplementation::add_executor_hop_batch(agrpc::GrpcContext& grpc_context,
+                                                              detail::TypeErasedExecutorHopBatch* batch) noexcept
+{
+    batch->next = std::exchange(grpc_context.executor_hop_batches, batch);
+}
+
+template <detail::InvokeHandler Invoke>
+void GrpcContextImplementation::complete_executor_hops(agrpc::GrpcContext& grpc_context)
+{
+    auto* batch = std::exchange(grpc_context.executor_hop_batches, nullptr);
+    while (batch != nullptr)
+    {
+        // Completing a batch destroys it
+        auto* next = batch->next;
+        batch->complete(Invoke, grpc_context.get_allocator());
+        batch = next;
+    }
+}
+
 inline void GrpcContextImplementation::move_remote_work_to_local_queue(agrpc::GrpcContext& grpc_context) noexcept
 {
     while (true)
@@ -96,6 +165,19 @@ void GrpcContextImplementation::process_local_queue(agrpc::GrpcContext& grpc_con
     }
 }
 
+// Operations that are added while the idle queue is being processed run in the next iteration of process_work
+template <detail::InvokeHandler Invoke>
+void GrpcContextImplementation::process_idle_queue(agrpc::GrpcContext& grpc_context)
+{
+    auto idle_work_queue = std::move(grpc_context.idle_work_queue);
+    while (!idle_work_queue.empty())
+    {
+        detail::WorkFinishedOnExit on_exit{grpc_context};
+        auto* operation = idle_work_queue.pop_front();
+        operation->complete(Invoke, grpc_context.get_allocator());
+    }
+}
+
 template <detail::InvokeHandler Invoke, class IsStoppedPredicate>
 bool GrpcContextImplementation::process_work(agrpc::GrpcContext& grpc_context, IsStoppedPredicate is_stopped_predicate)
 {
@@ -109,7 +191,19 @@ bool GrpcContextImplementation::process_work(agrpc::GrpcContext& grpc_context, I
     {
         return false;
     }
-    if (detail::GrpcCompletionQueueEvent event; detail::GrpcContextImplementation::get_next_event(grpc_context, event))
+    // While completions are waiting to hop to other executors or idle work is pending only the events that are ready
+    // right away are processed, the idle work runs once there are none left
+    const auto is_waiting = grpc_context.executor_hop_batches != nullptr || !grpc_context.idle_work_queue.empty();
+    const auto& deadline = is_waiting ? detail::TIME_ZERO : detail::INFINITE_FUTURE;
+    detail::GrpcCompletionQueueEvent event;
+    const auto status = detail::GrpcContextImplementation::get_next_event(grpc_context, event, deadline);
+    if (status == grpc::CompletionQueue::TIMEOUT)
+    {
+        detail::GrpcContextImplementation::complete_executor_hops<Invoke>(grpc_context);
+        detail::GrpcContextImplementation::process_idle_queue<Invoke>(grpc_context);
+        return true;
+    }
+    if (status == grpc::CompletionQueue::GOT_EVENT)
     {
         if (event.tag == detail::GrpcContextImplementation::HAS_REMOTE_WORK_TAG)
         {
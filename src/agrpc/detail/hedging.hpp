@@ -0,0 +1,168 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_HEDGING_HPP
+#define AGRPC_DETAIL_HEDGING_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/alarm.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <grpcpp/support/status.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc::detail
+{
+template <class Response>
+struct HedgedAttempt
+{
+    std::unique_ptr<grpc::ClientContext> client_context{std::make_unique<grpc::ClientContext>()};
+    std::unique_ptr<grpc::ClientAsyncResponseReader<Response>> reader;
+    Response response;
+    grpc::Status status;
+    std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+    bool is_finished{false};
+};
+
+template <class Response, class StartCall, class LatencyTracker>
+class HedgedCall : public std::enable_shared_from_this<HedgedCall<Response, StartCall, LatencyTracker>>
+{
+  public:
+    HedgedCall(agrpc::GrpcContext& grpc_context, LatencyTracker& latency_tracker, std::size_t max_attempts,
+               StartCall start_call, Response& response, grpc::Status& status,
+               detail::TypeErasedGrpcTagOperation* on_done)
+        : grpc_context(grpc_context),
+          latency_tracker(latency_tracker),
+          max_attempts(max_attempts),
+          start_call(std::move(start_call)),
+          response(response),
+          status(status),
+          on_done(on_done)
+    {
+        this->attempts.reserve(max_attempts);
+    }
+
+    HedgedCall(const HedgedCall&) = delete;
+    HedgedCall(HedgedCall&&) = delete;
+    HedgedCall& operator=(const HedgedCall&) = delete;
+    HedgedCall& operator=(HedgedCall&&) = delete;
+
+    ~HedgedCall() noexcept
+    {
+        if (this->on_done)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            this->on_done->complete(detail::InvokeHandler::NO, false, this->grpc_context.get_allocator());
+        }
+    }
+
+    void start_attempt()
+    {
+        const auto index = this->attempts.size();
+        auto& attempt = this->attempts.emplace_back();
+        attempt.reader = this->start_call(*attempt.client_context, this->grpc_context.get_completion_queue(), index);
+        agrpc::finish(*attempt.reader, attempt.response, attempt.status,
+                      asio::bind_executor(this->grpc_context,
+                                          [self = this->shared_from_this(), index](bool ok)
+                                          {
+                                              self->on_finish(index, ok);
+                                          }));
+        if (this->attempts.size() < this->max_attempts)
+        {
+            agrpc::wait(this->alarm, std::chrono::system_clock::now() + this->latency_tracker.delay(),
+                        asio::bind_executor(this->grpc_context,
+                                            [self = this->shared_from_this()](bool ok)
+                                            {
+                                                if (ok && self->on_done)
+                                                {
+                                                    self->start_attempt();
+                                                }
+                                            }));
+        }
+    }
+
+  private:
+    void on_finish(std::size_t index, bool ok)
+    {
+        auto& attempt = this->attempts[index];
+        attempt.is_finished = true;
+        if (!this->on_done)
+        {
+            return;
+        }
+        const bool is_success = ok && attempt.status.ok();
+        if (!is_success && !this->is_last_pending_attempt())
+        {
+            return;
+        }
+        if (is_success)
+        {
+            this->latency_tracker.record(std::chrono::steady_clock::now() - attempt.start_time);
+        }
+        this->alarm.Cancel();
+        for (auto& other : this->attempts)
+        {
+            if (!other.is_finished)
+            {
+                other.client_context->TryCancel();
+            }
+        }
+        this->response = std::move(attempt.response);
+        this->status = std::move(attempt.status);
+        detail::WorkFinishedOnExit on_exit{this->grpc_context};
+        std::exchange(this->on_done, nullptr)
+            ->complete(detail::InvokeHandler::YES, ok, this->grpc_context.get_allocator());
+    }
+
+    [[nodiscard]] bool is_last_pending_attempt() const noexcept
+    {
+        if (this->attempts.size() < this->max_attempts)
+        {
+            return false;
+        }
+        for (const auto& attempt : this->attempts)
+        {
+            if (!attempt.is_finished)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    LatencyTracker& latency_tracker;
+    std::size_t max_attempts;
+    StartCall start_call;
+    Response& response;
+    grpc::Status& status;
+    detail::TypeErasedGrpcTagOperation* on_done;
+    grpc::Alarm alarm;
+    std::vector<detail::HedgedAttempt<Response>> attempts;
+};
+}  // namespace agrpc::detail
+#endif
+
+#endif  // AGRPC_DETAIL_HEDGING_HPP
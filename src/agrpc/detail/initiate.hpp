@@ -18,10 +18,16 @@
 #include "agrpc/detail/asioForward.hpp"
 #include "agrpc/detail/attributes.hpp"
 #include "agrpc/detail/completionHandlerWithPayload.hpp"
+#include "agrpc/detail/executorHop.hpp"
 #include "agrpc/detail/grpcContextImplementation.hpp"
 #include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/detail/utility.hpp"
 #include "agrpc/grpcContext.hpp"
 
+#include <optional>
+#include <type_traits>
+
 #if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
 namespace agrpc::detail
 {
@@ -45,7 +51,35 @@ struct GrpcInitiator
     void operator()(CompletionHandler completion_handler)
     {
         const auto [executor, allocator] = detail::get_associated_executor_and_allocator(completion_handler);
-        auto& grpc_context = detail::query_grpc_context(executor);
+        if constexpr (detail::MAY_BE_GRPC_EXECUTOR_V<detail::RemoveCvrefT<decltype(executor)>>)
+        {
+            if (detail::is_grpc_executor(executor)) AGRPC_LIKELY
+                {
+                    this->initiate(std::move(completion_handler), detail::query_grpc_context(executor), allocator);
+                    return;
+                }
+        }
+        if (auto* grpc_context = detail::grpc_context_of(executor))
+        {
+            // Executors of the GrpcContext, like strands, are dispatched to when the operation completes
+            this->initiate(detail::dispatch_to_associated_executor(std::move(completion_handler)), *grpc_context,
+                           allocator);
+            return;
+        }
+        this->initiate_executor_hop(std::move(completion_handler), allocator);
+    }
+
+    [[nodiscard]] executor_type get_executor() const noexcept { return asio::get_associated_executor(this->function); }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return asio::get_associated_allocator(this->function);
+    }
+
+  private:
+    template <class CompletionHandler, class Allocator>
+    void initiate(CompletionHandler completion_handler, agrpc::GrpcContext& grpc_context, const Allocator& allocator)
+    {
         if (grpc_context.is_stopped()) AGRPC_UNLIKELY
             {
                 return;
@@ -69,11 +103,21 @@ struct GrpcInitiator
         on_exit.release();
     }
 
-    [[nodiscard]] executor_type get_executor() const noexcept { return asio::get_associated_executor(this->function); }
-
-    [[nodiscard]] allocator_type get_allocator() const noexcept
+    template <class CompletionHandler, class Allocator>
+    void initiate_executor_hop(CompletionHandler completion_handler, const Allocator& allocator)
     {
-        return asio::get_associated_allocator(this->function);
+        auto& grpc_context = detail::hop_grpc_context();
+        if (grpc_context.is_stopped()) AGRPC_UNLIKELY
+            {
+                return;
+            }
+        grpc_context.work_started();
+        detail::WorkFinishedOnExit on_exit{grpc_context};
+        auto operation = detail::allocate<detail::ExecutorHopOperation<CompletionHandler, Allocator>>(
+            allocator, grpc_context, std::move(completion_handler), allocator);
+        std::move(this->function)(grpc_context, operation.get());
+        operation.release();
+        on_exit.release();
     }
 };
 
@@ -101,6 +145,107 @@ struct DefaultCompletionTokenNotAvailable
 {
     DefaultCompletionTokenNotAvailable() = delete;
 };
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+template <class Initiation>
+inline constexpr bool IS_GRPC_INITIATOR_V = false;
+
+template <class Function>
+inline constexpr bool IS_GRPC_INITIATOR_V<detail::GrpcInitiator<Function>> = true;
+
+// Completion queue tag that lives in the frame of the coroutine that awaits it
+template <class Handler>
+class InlineAwaitableOperation : public detail::TypeErasedGrpcTagOperation
+{
+  public:
+    InlineAwaitableOperation() noexcept : detail::TypeErasedGrpcTagOperation(&InlineAwaitableOperation::do_complete) {}
+
+    template <class Frame, class Function>
+    Handler* start(Frame* frame, Function& function)
+    {
+        Handler local_handler{frame->detach_thread()};
+        auto& grpc_context = detail::query_grpc_context(asio::get_associated_executor(local_handler));
+        if (grpc_context.is_stopped()) AGRPC_UNLIKELY
+            {
+                return nullptr;
+            }
+        grpc_context.work_started();
+        detail::WorkFinishedOnExit on_exit{grpc_context};
+        this->handler.emplace(std::move(local_handler));
+        std::move(function)(grpc_context, this);
+        on_exit.release();
+        return nullptr;
+    }
+
+  private:
+    static void do_complete(detail::TypeErasedGrpcTagOperation* op, detail::InvokeHandler invoke_handler, bool ok,
+                            detail::GrpcContextLocalAllocator)
+    {
+        auto* self = static_cast<InlineAwaitableOperation*>(op);
+
+        // Resuming the coroutine destroys this operation
+        auto local_handler{std::move(*self->handler)};
+        if (detail::InvokeHandler::YES == invoke_handler)
+        {
+            std::move(local_handler)(ok);
+        }
+    }
+
+    std::optional<Handler> handler;
+};
+
+// Operations other than plain grpc_initiate with a void(bool) signature and coroutines whose executor is not a
+// GrpcExecutor fall back to asio::use_awaitable
+template <class Executor, class Signature>
+class UseAwaitableInlineAsyncResult
+{
+  private:
+    using Fallback = asio::async_result<asio::use_awaitable_t<Executor>, Signature>;
+    using handler_type = asio::detail::awaitable_handler<Executor, bool>;
+
+  public:
+    using return_type = typename Fallback::return_type;
+
+    template <class Initiation, class CompletionToken, class... Args>
+    static return_type initiate(Initiation&& initiation, CompletionToken&&, Args&&... args)
+    {
+        if constexpr (std::is_same_v<void(bool), Signature> &&
+                      detail::IS_GRPC_INITIATOR_V<detail::RemoveCvrefT<Initiation>>)
+        {
+            return UseAwaitableInlineAsyncResult::initiate_inline(std::forward<Initiation>(initiation).function);
+        }
+        else
+        {
+            return Fallback::initiate(std::forward<Initiation>(initiation), asio::use_awaitable_t<Executor>{},
+                                      std::forward<Args>(args)...);
+        }
+    }
+
+  private:
+    template <class Function>
+    static return_type initiate_inline(Function function)
+    {
+        if constexpr (detail::MAY_BE_GRPC_EXECUTOR_V<Executor>)
+        {
+            // The completion handler is invoked by the GrpcContext directly, which is only correct for a GrpcExecutor
+            if (detail::is_grpc_executor(co_await asio::this_coro::executor)) AGRPC_LIKELY
+                {
+                    detail::InlineAwaitableOperation<handler_type> operation;
+                    co_await [&](auto* frame)
+                    {
+                        return operation.start(frame, function);
+                    };
+                    // Never reached, the completion handler resumes the awaiting coroutine directly
+                    for (;;)
+                    {
+                    }
+                }
+        }
+        co_return co_await Fallback::initiate(detail::GrpcInitiator<Function>{std::move(function)},
+                                              asio::use_awaitable_t<Executor>{});
+    }
+};
+#endif
 }  // namespace agrpc::detail
 
 #ifdef AGRPC_STANDALONE_ASIO
@@ -0,0 +1,106 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_MULTIPLEXER_HPP
+#define AGRPC_DETAIL_MULTIPLEXER_HPP
+
+#include "agrpc/detail/serialization.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+
+#include <grpcpp/impl/codegen/serialization_traits.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/slice.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace agrpc::detail
+{
+inline constexpr std::size_t CORRELATION_ID_SIZE = sizeof(std::uint64_t);
+
+// Prepends the little-endian correlation id to the serialized message without copying the message's slices.
+template <class Message>
+bool frame_message(std::uint64_t id, const Message& message, grpc::ByteBuffer& buffer)
+{
+    grpc::ByteBuffer payload;
+    if (!detail::serialize(message, payload))
+    {
+        return false;
+    }
+    std::vector<grpc::Slice> slices;
+    if (!payload.Dump(&slices).ok())
+    {
+        return false;
+    }
+    std::uint8_t id_bytes[CORRELATION_ID_SIZE];
+    for (std::size_t i = 0; i < CORRELATION_ID_SIZE; ++i)
+    {
+        id_bytes[i] = static_cast<std::uint8_t>(id >> (8 * i));
+    }
+    slices.insert(slices.begin(), grpc::Slice{id_bytes, CORRELATION_ID_SIZE});
+    buffer = grpc::ByteBuffer{slices.data(), slices.size()};
+    return true;
+}
+
+[[nodiscard]] inline bool read_correlation_id(const grpc::ByteBuffer& buffer, std::uint64_t& id,
+                                              std::vector<grpc::Slice>& payload)
+{
+    if (buffer.Length() < CORRELATION_ID_SIZE || !buffer.Dump(&payload).ok())
+    {
+        return false;
+    }
+    id = 0;
+    std::size_t read_bytes{};
+    auto slice = payload.begin();
+    while (read_bytes < CORRELATION_ID_SIZE)
+    {
+        const auto available = std::min(slice->size(), CORRELATION_ID_SIZE - read_bytes);
+        for (std::size_t i = 0; i < available; ++i)
+        {
+            id |= std::uint64_t{slice->begin()[i]} << (8 * (read_bytes + i));
+        }
+        read_bytes += available;
+        if (available == slice->size())
+        {
+            slice = payload.erase(slice);
+        }
+        else
+        {
+            *slice = slice->sub(available, slice->size());
+        }
+    }
+    return true;
+}
+
+template <class Message>
+bool deserialize_payload(std::vector<grpc::Slice>& payload, Message& message)
+{
+    grpc::ByteBuffer buffer{payload.data(), payload.size()};
+    return grpc::SerializationTraits<Message>::Deserialize(&buffer, &message).ok();
+}
+
+using MultiplexedCallOperation = detail::TypeErasedGrpcTagOperation;
+
+template <class Response>
+struct MultiplexedCall
+{
+    detail::MultiplexedCallOperation* operation;
+    Response* response;
+};
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_MULTIPLEXER_HPP
@@ -0,0 +1,316 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_PROXY_HPP
+#define AGRPC_DETAIL_PROXY_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/attributes.hpp"
+#include "agrpc/detail/grpcContext.hpp"
+#include "agrpc/detail/memory.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/support/byte_buffer.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc::detail
+{
+[[nodiscard]] inline bool is_forwardable_metadata(grpc::string_ref key) noexcept
+{
+    return !key.starts_with(":") && !key.starts_with("grpc-");
+}
+
+template <class Multimap, class Function>
+void forward_metadata(const Multimap& metadata, Function function)
+{
+    for (const auto& [key, value] : metadata)
+    {
+        if (detail::is_forwardable_metadata(key))
+        {
+            function(std::string{key.data(), key.size()}, std::string{value.data(), value.size()});
+        }
+    }
+}
+
+struct ProxyCall;
+
+using ProxyCallPointer = detail::RebindAllocatedPointer<detail::ProxyCall, detail::GrpcContextLocalAllocator>;
+
+// Keeps the ProxyCall alive as long as at least one of its completion handlers exists, including handlers that are
+// destroyed without being invoked when the GrpcContext is destructed.
+class ProxyCallReference
+{
+  public:
+    explicit ProxyCallReference(detail::ProxyCall& call) noexcept;
+
+    ProxyCallReference(ProxyCallReference&& other) noexcept : call(std::exchange(other.call, nullptr)) {}
+
+    ProxyCallReference(const ProxyCallReference&) = delete;
+    ProxyCallReference& operator=(const ProxyCallReference&) = delete;
+    ProxyCallReference& operator=(ProxyCallReference&&) = delete;
+
+    ~ProxyCallReference() noexcept;
+
+  private:
+    detail::ProxyCall* call;
+};
+
+struct ProxyCall
+{
+    agrpc::GrpcContext& grpc_context;
+    grpc::GenericServerContext server_context;
+    grpc::GenericServerAsyncReaderWriter server_reader_writer{&server_context};
+    std::unique_ptr<grpc::ClientContext> client_context;
+    std::unique_ptr<grpc::GenericClientAsyncReaderWriter> client_reader_writer;
+    grpc::ByteBuffer client_to_backend;
+    grpc::ByteBuffer backend_to_client;
+    grpc::Status status;
+    std::size_t reference_count{};
+    bool is_writing_to_backend{false};
+    bool is_backend_done{false};
+    bool is_backend_finished{false};
+
+    explicit ProxyCall(agrpc::GrpcContext& grpc_context) : grpc_context(grpc_context) {}
+
+    template <class BackendPicker>
+    void start(BackendPicker& backend_picker)
+    {
+        this->client_context = grpc::ClientContext::FromServerContext(this->server_context);
+        detail::forward_metadata(this->server_context.client_metadata(),
+                                 [&](std::string key, std::string value)
+                                 {
+                                     this->client_context->AddMetadata(std::move(key), std::move(value));
+                                 });
+        grpc::GenericStub& stub = backend_picker(this->server_context);
+        agrpc::request(this->server_context.method(), stub, *this->client_context, this->client_reader_writer,
+                       this->bind(
+                           [this](bool ok)
+                           {
+                               if (ok)
+                               {
+                                   this->read_from_client();
+                                   this->read_initial_metadata_from_backend();
+                               }
+                               else
+                               {
+                                   this->end_backend_to_client();
+                               }
+                           }));
+    }
+
+    template <class Function>
+    auto bind(Function function)
+    {
+        return asio::bind_executor(this->grpc_context,
+                                   [reference = detail::ProxyCallReference{*this}, function](bool ok) mutable
+                                   {
+                                       function(ok);
+                                   });
+    }
+
+    // client -> backend
+    void read_from_client()
+    {
+        agrpc::read(this->server_reader_writer, this->client_to_backend,
+                    this->bind(
+                        [this](bool ok)
+                        {
+                            if (this->is_backend_done)
+                            {
+                                // The backend ended the call, nothing may be written to it anymore
+                                return;
+                            }
+                            if (ok)
+                            {
+                                this->write_to_backend();
+                            }
+                            else
+                            {
+                                this->writes_done_to_backend();
+                            }
+                        }));
+    }
+
+    void write_to_backend()
+    {
+        this->is_writing_to_backend = true;
+        agrpc::write(*this->client_reader_writer, this->client_to_backend,
+                     this->bind(
+                         [this](bool ok)
+                         {
+                             this->is_writing_to_backend = false;
+                             if (ok && !this->is_backend_done)
+                             {
+                                 this->read_from_client();
+                             }
+                             else
+                             {
+                                 this->finish_backend_if_done();
+                             }
+                         }));
+    }
+
+    void writes_done_to_backend()
+    {
+        this->is_writing_to_backend = true;
+        agrpc::writes_done(*this->client_reader_writer, this->bind(
+                                                            [this](bool)
+                                                            {
+                                                                this->is_writing_to_backend = false;
+                                                                this->finish_backend_if_done();
+                                                            }));
+    }
+
+    // backend -> client
+    void read_initial_metadata_from_backend()
+    {
+        agrpc::read_initial_metadata(*this->client_reader_writer,
+                                     this->bind(
+                                         [this](bool ok)
+                                         {
+                                             if (!ok)
+                                             {
+                                                 this->end_backend_to_client();
+                                                 return;
+                                             }
+                                             detail::forward_metadata(
+                                                 this->client_context->GetServerInitialMetadata(),
+                                                 [&](std::string key, std::string value)
+                                                 {
+                                                     this->server_context.AddInitialMetadata(std::move(key),
+                                                                                             std::move(value));
+                                                 });
+                                             this->read_from_backend();
+                                         }));
+    }
+
+    void read_from_backend()
+    {
+        agrpc::read(*this->client_reader_writer, this->backend_to_client,
+                    this->bind(
+                        [this](bool ok)
+                        {
+                            if (ok)
+                            {
+                                this->write_to_client();
+                            }
+                            else
+                            {
+                                this->end_backend_to_client();
+                            }
+                        }));
+    }
+
+    void write_to_client()
+    {
+        agrpc::write(this->server_reader_writer, this->backend_to_client,
+                     this->bind(
+                         [this](bool ok)
+                         {
+                             if (ok)
+                             {
+                                 this->read_from_backend();
+                             }
+                             else
+                             {
+                                 this->client_context->TryCancel();
+                                 this->end_backend_to_client();
+                             }
+                         }));
+    }
+
+    void end_backend_to_client()
+    {
+        this->is_backend_done = true;
+        this->finish_backend_if_done();
+    }
+
+    // The backend is finished once nothing flows from it anymore and the last write or writes_done to it completed. A
+    // read from the client may still be pending, the server-side Finish below ends the call early in that case.
+    void finish_backend_if_done()
+    {
+        if (!this->is_backend_done || this->is_writing_to_backend || this->is_backend_finished)
+        {
+            return;
+        }
+        this->is_backend_finished = true;
+        agrpc::finish(*this->client_reader_writer, this->status,
+                      this->bind(
+                          [this](bool)
+                          {
+                              detail::forward_metadata(this->client_context->GetServerTrailingMetadata(),
+                                                       [&](std::string key, std::string value)
+                                                       {
+                                                           this->server_context.AddTrailingMetadata(std::move(key),
+                                                                                                    std::move(value));
+                                                       });
+                              agrpc::finish(this->server_reader_writer, this->status, this->bind([](bool) {}));
+                          }));
+    }
+
+    void reject(const grpc::Status& reject_status)
+    {
+        agrpc::finish(this->server_reader_writer, reject_status, this->bind([](bool) {}));
+    }
+};
+
+inline ProxyCallReference::ProxyCallReference(detail::ProxyCall& call) noexcept : call(&call)
+{
+    ++call.reference_count;
+}
+
+inline ProxyCallReference::~ProxyCallReference() noexcept
+{
+    if (this->call && --this->call->reference_count == 0)
+    {
+        detail::ProxyCallPointer ptr{this->call, this->call->grpc_context.get_allocator()};
+    }
+}
+
+template <class Proxy>
+struct ProxyRequestHandler
+{
+    Proxy& proxy;
+    detail::ProxyCallPointer call;
+
+    void operator()(bool ok)
+    {
+        if (!ok) AGRPC_UNLIKELY
+            {
+                return;
+            }
+        auto& proxy_call = *this->call;
+        this->call.release();
+        if (this->proxy.is_stopped)
+        {
+            proxy_call.reject(grpc::Status{grpc::StatusCode::UNAVAILABLE, "proxy is stopped"});
+            return;
+        }
+        this->proxy.request_next();
+        proxy_call.start(this->proxy.backend_picker);
+    }
+};
+}  // namespace agrpc::detail
+#endif
+
+#endif  // AGRPC_DETAIL_PROXY_HPP
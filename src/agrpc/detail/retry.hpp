@@ -0,0 +1,164 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_RETRY_HPP
+#define AGRPC_DETAIL_RETRY_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/memory.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/alarm.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <grpcpp/support/status.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc::detail
+{
+template <class Duration>
+Duration apply_full_jitter(Duration backoff)
+{
+    thread_local std::minstd_rand engine{std::random_device{}()};
+    std::uniform_real_distribution<double> distribution{0.0, 1.0};
+    return std::chrono::duration_cast<Duration>(backoff * distribution(engine));
+}
+
+template <class Response, class StartCall, class RetryPolicy, class RetryBudget>
+struct RetryCall
+{
+    using Pointer = detail::RebindAllocatedPointer<RetryCall, detail::GrpcContextLocalAllocator>;
+
+    agrpc::GrpcContext& grpc_context;
+    RetryBudget& retry_budget;
+    RetryPolicy policy;
+    StartCall start_call;
+    Response& response;
+    grpc::Status& status;
+    detail::TypeErasedGrpcTagOperation* on_done;
+    std::unique_ptr<grpc::ClientContext> client_context;
+    std::unique_ptr<grpc::ClientAsyncResponseReader<Response>> reader;
+    grpc::Alarm alarm;
+    std::size_t attempt{};
+    typename RetryPolicy::Duration backoff{policy.initial_backoff};
+
+    RetryCall(agrpc::GrpcContext& grpc_context, RetryBudget& retry_budget, RetryPolicy policy, StartCall start_call,
+              Response& response, grpc::Status& status, detail::TypeErasedGrpcTagOperation* on_done)
+        : grpc_context(grpc_context),
+          retry_budget(retry_budget),
+          policy(std::move(policy)),
+          start_call(std::move(start_call)),
+          response(response),
+          status(status),
+          on_done(on_done)
+    {
+    }
+
+    RetryCall(const RetryCall&) = delete;
+    RetryCall(RetryCall&&) = delete;
+    RetryCall& operator=(const RetryCall&) = delete;
+    RetryCall& operator=(RetryCall&&) = delete;
+
+    ~RetryCall() noexcept
+    {
+        if (this->on_done)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            this->on_done->complete(detail::InvokeHandler::NO, false, this->grpc_context.get_allocator());
+        }
+    }
+
+    static void start_attempt(Pointer ptr)
+    {
+        auto& self = *ptr;
+        self.client_context = std::make_unique<grpc::ClientContext>();
+        self.reader = self.start_call(*self.client_context, self.grpc_context.get_completion_queue(), self.attempt);
+        agrpc::finish(*self.reader, self.response, self.status,
+                      asio::bind_executor(self.grpc_context,
+                                          [ptr = std::move(ptr)](bool ok) mutable
+                                          {
+                                              RetryCall::on_finish(std::move(ptr), ok);
+                                          }));
+    }
+
+    static void on_finish(Pointer ptr, bool ok)
+    {
+        auto& self = *ptr;
+        // The status is only meaningful if the Finish succeeded
+        if (!ok)
+        {
+            RetryCall::complete(std::move(ptr), ok);
+            return;
+        }
+        if (self.status.ok())
+        {
+            self.retry_budget.on_success();
+            RetryCall::complete(std::move(ptr), ok);
+            return;
+        }
+        if (!self.policy.is_retryable(self.status.error_code()))
+        {
+            RetryCall::complete(std::move(ptr), ok);
+            return;
+        }
+        self.retry_budget.on_failure();
+        ++self.attempt;
+        if (self.attempt >= self.policy.max_attempts || !self.retry_budget.is_retry_allowed())
+        {
+            RetryCall::complete(std::move(ptr), ok);
+            return;
+        }
+        const auto delay = detail::apply_full_jitter(self.backoff);
+        self.backoff = std::min(std::chrono::duration_cast<typename RetryPolicy::Duration>(
+                                    self.backoff * self.policy.backoff_multiplier),
+                                self.policy.max_backoff);
+        agrpc::wait(self.alarm, std::chrono::system_clock::now() + delay,
+                    asio::bind_executor(self.grpc_context,
+                                        [ptr = std::move(ptr), ok](bool wait_ok) mutable
+                                        {
+                                            if (wait_ok)
+                                            {
+                                                RetryCall::start_attempt(std::move(ptr));
+                                            }
+                                            else
+                                            {
+                                                RetryCall::complete(std::move(ptr), ok);
+                                            }
+                                        }));
+    }
+
+    static void complete(Pointer ptr, bool ok)
+    {
+        auto& grpc_context = ptr->grpc_context;
+        auto* on_done = std::exchange(ptr->on_done, nullptr);
+        ptr.reset();
+        detail::WorkFinishedOnExit on_exit{grpc_context};
+        on_done->complete(detail::InvokeHandler::YES, ok, grpc_context.get_allocator());
+    }
+};
+}  // namespace agrpc::detail
+#endif
+
+#endif  // AGRPC_DETAIL_RETRY_HPP
@@ -17,6 +17,9 @@
 
 #include "agrpc/detail/asioForward.hpp"
 #include "agrpc/detail/attributes.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
 #include "agrpc/initiate.hpp"
 
 #include <grpcpp/alarm.h>
@@ -24,7 +27,16 @@
 #include <grpcpp/completion_queue.h>
 #include <grpcpp/server_context.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace agrpc
 {
@@ -66,9 +78,158 @@ struct AlarmCancellationHandler
         }
     }
 };
+
+template <class Context>
+struct RPCCancellationHandler
+{
+    Context& context;
+
+    constexpr explicit RPCCancellationHandler(Context& context) noexcept : context(context) {}
+
+    void operator()(asio::cancellation_type type)
+    {
+        if (static_cast<bool>(type & asio::cancellation_type::all))
+        {
+            context.TryCancel();
+        }
+    }
+};
+#endif
+
+inline std::unique_ptr<grpc::ClientContext> create_child_context(const grpc::ServerContext& server_context,
+                                                                 std::chrono::system_clock::duration safety_margin,
+                                                                 grpc::PropagationOptions options)
+{
+    auto client_context = grpc::ClientContext::FromServerContext(server_context, options);
+    if (const auto deadline = server_context.deadline(); deadline != (std::chrono::system_clock::time_point::max)())
+    {
+        client_context->set_deadline(deadline - safety_margin);
+    }
+    return client_context;
+}
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+template <class Context>
+inline constexpr bool IS_RPC_CONTEXT_V =
+    std::is_base_of_v<grpc::ClientContext, Context> || std::is_base_of_v<grpc::ServerContext, Context>;
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+// Clears the cancellation slot before invoking the completion handler, the RPCCancellationHandler in it refers to a
+// context that may be destroyed by the completion handler
+template <class CompletionHandler>
+class RPCCancellationCompletionHandler
+{
+  private:
+    using Slot = asio::associated_cancellation_slot_t<CompletionHandler>;
+
+  public:
+    using executor_type = asio::associated_executor_t<CompletionHandler>;
+    using allocator_type = asio::associated_allocator_t<CompletionHandler>;
+
+    RPCCancellationCompletionHandler(CompletionHandler completion_handler, Slot slot)
+        : completion_handler(std::move(completion_handler)), slot(std::move(slot))
+    {
+    }
+
+    template <class... Args>
+    void operator()(Args&&... args)
+    {
+        this->slot.clear();
+        std::move(this->completion_handler)(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] executor_type get_executor() const noexcept
+    {
+        return asio::get_associated_executor(this->completion_handler);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return asio::get_associated_allocator(this->completion_handler);
+    }
+
+  private:
+    CompletionHandler completion_handler;
+    Slot slot;
+};
+#endif
+
+// Invokes initiation(completion_handler) after connecting the cancellation slot of the completion handler to TryCancel
+// of the context
+template <class Signature, class Context, class Initiation, class CompletionToken>
+auto initiate_with_rpc_cancellation([[maybe_unused]] Context& context, Initiation initiation, CompletionToken&& token)
+{
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    return asio::async_initiate<detail::RemoveCvrefT<CompletionToken>, Signature>(
+        [&context](auto completion_handler, Initiation initiation)
+        {
+            if (auto slot = asio::get_associated_cancellation_slot(completion_handler); slot.is_connected())
+            {
+                slot.template emplace<detail::RPCCancellationHandler<Context>>(context);
+                std::move(initiation)(detail::RPCCancellationCompletionHandler<decltype(completion_handler)>{
+                    std::move(completion_handler), std::move(slot)});
+                return;
+            }
+            std::move(initiation)(std::move(completion_handler));
+        },
+        token, std::move(initiation));
+#else
+    return std::move(initiation)(std::forward<CompletionToken>(token));
+#endif
+}
+
+template <class Context, class Function, class CompletionToken>
+auto grpc_initiate_with_rpc_cancellation(Context& context, Function function, CompletionToken&& token)
+{
+    return detail::initiate_with_rpc_cancellation<void(bool)>(
+        context,
+        [function = std::move(function)](auto&& completion_handler) mutable
+        {
+            return agrpc::grpc_initiate(std::move(function),
+                                        std::forward<decltype(completion_handler)>(completion_handler));
+        },
+        std::forward<CompletionToken>(token));
+}
+
+template <class Payload, class Context, class Function, class CompletionToken>
+auto grpc_initiate_with_payload_and_rpc_cancellation(Context& context, Function function, CompletionToken&& token)
+{
+    return detail::initiate_with_rpc_cancellation<void(std::pair<Payload, bool>)>(
+        context,
+        [function = std::move(function)](auto&& completion_handler) mutable
+        {
+            return detail::grpc_initiate_with_payload<Payload>(
+                std::move(function), std::forward<decltype(completion_handler)>(completion_handler));
+        },
+        std::forward<CompletionToken>(token));
+}
+
+template <class Context, class Function, class Arguments, std::size_t... I>
+auto initiate_with_rpc_cancellation_from_last(Context& context, Function function, Arguments arguments,
+                                              std::index_sequence<I...>)
+{
+    auto&& token = std::get<sizeof...(I)>(std::move(arguments));
+    return detail::initiate_with_rpc_cancellation<void(bool)>(
+        context,
+        [function = std::move(function), arguments = std::move(arguments)](auto&& completion_handler) mutable
+        {
+            return function(std::get<I>(arguments)..., std::forward<decltype(completion_handler)>(completion_handler));
+        },
+        std::forward<decltype(token)>(token));
+}
+
+// The last argument is the completion token
+template <class Context, class Function, class... Args>
+auto initiate_with_rpc_cancellation_from_last(Context& context, Function function, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(context, std::move(function),
+                                                            std::forward_as_tuple(std::forward<Args>(args)...),
+                                                            std::make_index_sequence<sizeof...(Args) - 1>{});
+}
 #endif
 }  // namespace detail
 
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
 template <class RPC, class Service, class Request, class Responder,
           class CompletionToken = agrpc::DefaultCompletionToken>
 auto request(detail::ServerMultiArgRequest<RPC, Request, Responder> rpc, Service& service,
@@ -78,7 +239,6 @@ template <class RPC, class Service, class Responder, class CompletionToken = agr
 auto request(detail::ServerSingleArgRequest<RPC, Responder> rpc, Service& service, grpc::ServerContext& server_context,
              Responder& responder, CompletionToken token = {});
 
-#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
 template <class RPCContextImplementationAllocator>
 class RPCRequestContext;
 
@@ -96,10 +256,157 @@ struct RPCContextImplementation
 struct RPCContextBase
 {
     grpc::ServerContext context{};
+
+    template <class Executor, class Allocator>
+    static constexpr void prepare_request(const Executor&, const Allocator&) noexcept
+    {
+    }
+
+    static constexpr void on_request_complete(bool) noexcept {}
+};
+
+struct NotifyWhenDoneState
+{
+    std::atomic_bool is_done{};
+    std::atomic_bool is_cancelled{};
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    asio::cancellation_signal signal;
+#endif
+    std::mutex mutex;
+    grpc::ServerContext* server_context{};
+    std::vector<std::weak_ptr<grpc::ClientContext>> children;
+
+    // Returns whether the RPC has been cancelled. IsCancelled() may no longer be called once the server context is
+    // destroyed, the RPC is then considered to have finished normally.
+    bool set_done()
+    {
+        std::lock_guard lock{this->mutex};
+        const bool cancelled = this->server_context != nullptr && this->server_context->IsCancelled();
+        this->is_cancelled.store(cancelled, std::memory_order_relaxed);
+        this->is_done.store(true, std::memory_order_release);
+        if (cancelled)
+        {
+            for (auto& weak_child : this->children)
+            {
+                if (auto child = weak_child.lock())
+                {
+                    child->TryCancel();
+                }
+            }
+        }
+        this->children.clear();
+        return cancelled;
+    }
+
+    void release_server_context()
+    {
+        std::lock_guard lock{this->mutex};
+        this->server_context = nullptr;
+    }
+
+    std::shared_ptr<grpc::ClientContext> add_child(std::shared_ptr<grpc::ClientContext> child)
+    {
+        std::lock_guard lock{this->mutex};
+        if (this->is_done.load(std::memory_order_relaxed))
+        {
+            if (this->is_cancelled.load(std::memory_order_relaxed))
+            {
+                child->TryCancel();
+            }
+            return child;
+        }
+        // Children whose call has finished and that have been released are dropped here
+        this->children.erase(std::remove_if(this->children.begin(), this->children.end(),
+                                            [](const auto& weak_child)
+                                            {
+                                                return weak_child.expired();
+                                            }),
+                             this->children.end());
+        this->children.emplace_back(child);
+        return child;
+    }
+};
+
+// The state is shared with the notification because gRPC may deliver it after the RPC context has been destroyed.
+struct NotifyWhenDoneRPCContextBase : detail::RPCContextBase
+{
+    std::shared_ptr<detail::NotifyWhenDoneState> state;
+    agrpc::GrpcContext* grpc_context{};
+    detail::TypeErasedGrpcTagOperation* operation{};
+
+    NotifyWhenDoneRPCContextBase() = default;
+
+    NotifyWhenDoneRPCContextBase(const NotifyWhenDoneRPCContextBase&) = delete;
+    NotifyWhenDoneRPCContextBase(NotifyWhenDoneRPCContextBase&&) = delete;
+    NotifyWhenDoneRPCContextBase& operator=(const NotifyWhenDoneRPCContextBase&) = delete;
+    NotifyWhenDoneRPCContextBase& operator=(NotifyWhenDoneRPCContextBase&&) = delete;
+
+    ~NotifyWhenDoneRPCContextBase()
+    {
+        if (this->state)
+        {
+            this->state->release_server_context();
+        }
+        // gRPC never delivers the notification of an RPC that did not start
+        if (this->operation != nullptr)
+        {
+            detail::WorkFinishedOnExit on_exit{*this->grpc_context};
+            this->operation->complete(detail::InvokeHandler::NO, false, this->grpc_context->get_allocator());
+        }
+    }
+
+    template <class Executor, class Allocator>
+    void prepare_request(const Executor& executor, const Allocator& allocator)
+    {
+        this->state = std::allocate_shared<detail::NotifyWhenDoneState>(allocator);
+        this->state->server_context = &this->context;
+        agrpc::grpc_initiate(
+            [&](agrpc::GrpcContext& grpc_context, void* tag)
+            {
+                this->grpc_context = &grpc_context;
+                this->operation = static_cast<detail::TypeErasedGrpcTagOperation*>(tag);
+                this->context.AsyncNotifyWhenDone(tag);
+            },
+            asio::bind_executor(executor,
+                                [state = this->state](bool)
+                                {
+                                    [[maybe_unused]] const bool is_cancelled = state->set_done();
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+                                    if (is_cancelled)
+                                    {
+                                        state->signal.emit(asio::cancellation_type::terminal);
+                                    }
+#endif
+                                }));
+    }
+
+    void on_request_complete(bool ok) noexcept
+    {
+        if (ok)
+        {
+            this->operation = nullptr;
+        }
+    }
+
+    [[nodiscard]] bool is_cancelled() const
+    {
+        return this->state->is_done.load(std::memory_order_acquire) &&
+               this->state->is_cancelled.load(std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<grpc::ClientContext> create_child_context(std::chrono::system_clock::duration safety_margin,
+                                                              grpc::PropagationOptions options)
+    {
+        return this->state->add_child(detail::create_child_context(this->context, safety_margin, options));
+    }
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    [[nodiscard]] asio::cancellation_slot cancellation_slot() const noexcept { return this->state->signal.slot(); }
+#endif
 };
 
-template <class Request, class Responder>
-struct MultiArgRPCContext : detail::RPCContextBase
+template <class Request, class Responder, class Base>
+struct MultiArgRPCContext : Base
 {
     Responder responder{&this->context};
     Request request{};
@@ -114,8 +421,8 @@ struct MultiArgRPCContext : detail::RPCContextBase
     constexpr auto args() noexcept { return std::forward_as_tuple(this->context, this->request, this->responder); }
 };
 
-template <class Responder>
-struct SingleArgRPCContext : detail::RPCContextBase
+template <class Responder, class Base>
+struct SingleArgRPCContext : Base
 {
     Responder responder{&this->context};
 
@@ -128,7 +435,7 @@ struct SingleArgRPCContext : detail::RPCContextBase
     constexpr auto args() noexcept { return std::forward_as_tuple(this->context, this->responder); }
 };
 
-template <class RPC, class Service, class RPCHandlerAllocator, class Handler>
+template <class RPC, class Service, class Base, class RPCHandlerAllocator, class Handler>
 struct RequestRepeater
 {
     using executor_type = asio::associated_executor_t<Handler>;
@@ -152,36 +459,41 @@ struct RequestRepeater
     allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler); }
 };
 
-template <class RPC, class Service, class Request, class Responder, class Handler>
+template <class Base, class RPC, class Service, class Request, class Responder, class Handler>
 void repeatedly_request(detail::ServerMultiArgRequest<RPC, Request, Responder> rpc, Service& service, Handler handler)
 {
     const auto [executor, allocator] = detail::get_associated_executor_and_allocator(handler);
-    auto rpc_handler = detail::allocate<detail::MultiArgRPCContext<Request, Responder>>(allocator);
+    auto rpc_handler = detail::allocate<detail::MultiArgRPCContext<Request, Responder, Base>>(allocator);
+    rpc_handler->prepare_request(executor, allocator);
     auto& context = rpc_handler->context;
     auto& request = rpc_handler->request;
     auto& responder = rpc_handler->responder;
     agrpc::request(rpc, service, context, request, responder,
-                   detail::RequestRepeater{rpc, service, std::move(rpc_handler), std::move(handler)});
+                   detail::RequestRepeater<decltype(rpc), Service, Base, typename decltype(rpc_handler)::allocator_type,
+                                           Handler>{rpc, service, std::move(rpc_handler), std::move(handler)});
 }
 
-template <class RPC, class Service, class Responder, class Handler>
+template <class Base, class RPC, class Service, class Responder, class Handler>
 void repeatedly_request(detail::ServerSingleArgRequest<RPC, Responder> rpc, Service& service, Handler handler)
 {
     const auto [executor, allocator] = detail::get_associated_executor_and_allocator(handler);
-    auto rpc_handler = detail::allocate<detail::SingleArgRPCContext<Responder>>(allocator);
+    auto rpc_handler = detail::allocate<detail::SingleArgRPCContext<Responder, Base>>(allocator);
+    rpc_handler->prepare_request(executor, allocator);
     auto& context = rpc_handler->context;
     auto& responder = rpc_handler->responder;
     agrpc::request(rpc, service, context, responder,
-                   detail::RequestRepeater{rpc, service, std::move(rpc_handler), std::move(handler)});
+                   detail::RequestRepeater<decltype(rpc), Service, Base, typename decltype(rpc_handler)::allocator_type,
+                                           Handler>{rpc, service, std::move(rpc_handler), std::move(handler)});
 }
 
-template <class RPC, class Service, class RPCHandler, class Handler>
-void RequestRepeater<RPC, Service, RPCHandler, Handler>::operator()(bool ok)
+template <class RPC, class Service, class Base, class RPCHandler, class Handler>
+void RequestRepeater<RPC, Service, Base, RPCHandler, Handler>::operator()(bool ok)
 {
+    this->rpc_handler->on_request_complete(ok);
     if (ok) AGRPC_LIKELY
         {
             auto next_handler{this->handler};
-            detail::repeatedly_request(this->rpc, this->service, std::move(next_handler));
+            detail::repeatedly_request<Base>(this->rpc, this->service, std::move(next_handler));
         }
     std::move(this->handler)(detail::RPCContextImplementation::create(std::move(this->rpc_handler)), ok);
 }
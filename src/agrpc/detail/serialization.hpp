@@ -0,0 +1,50 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_SERIALIZATION_HPP
+#define AGRPC_DETAIL_SERIALIZATION_HPP
+
+#include <grpcpp/impl/codegen/serialization_traits.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/slice.h>
+
+#include <string>
+#include <vector>
+
+namespace agrpc::detail
+{
+template <class Message>
+bool serialize(const Message& message, grpc::ByteBuffer& buffer)
+{
+    bool own_buffer;
+    return grpc::SerializationTraits<Message>::Serialize(message, &buffer, &own_buffer).ok();
+}
+
+inline bool append_bytes(const grpc::ByteBuffer& buffer, std::string& output)
+{
+    std::vector<grpc::Slice> slices;
+    if (!buffer.Dump(&slices).ok())
+    {
+        return false;
+    }
+    output.reserve(output.size() + buffer.Length());
+    for (const auto& slice : slices)
+    {
+        output.append(reinterpret_cast<const char*>(slice.begin()), slice.size());
+    }
+    return true;
+}
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_SERIALIZATION_HPP
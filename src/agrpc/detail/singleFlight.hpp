@@ -0,0 +1,115 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_SINGLEFLIGHT_HPP
+#define AGRPC_DETAIL_SINGLEFLIGHT_HPP
+
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/intrusiveQueue.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+
+#include <memory>
+#include <utility>
+
+namespace agrpc::detail
+{
+template <class Result>
+using SingleFlightOperation =
+    detail::TypeErasedOperation<true, std::shared_ptr<const Result>, detail::GrpcContextLocalAllocator>;
+
+template <class Result>
+using SingleFlightWaiterQueue = detail::IntrusiveQueue<detail::SingleFlightOperation<Result>>;
+
+template <class Result>
+class SingleFlightWaiters
+{
+  public:
+    SingleFlightWaiters(agrpc::GrpcContext& grpc_context, detail::SingleFlightWaiterQueue<Result>&& waiters,
+                        std::shared_ptr<const Result> result) noexcept
+        : grpc_context(&grpc_context), waiters(std::move(waiters)), result(std::move(result))
+    {
+    }
+
+    SingleFlightWaiters(SingleFlightWaiters&&) noexcept = default;
+    SingleFlightWaiters& operator=(SingleFlightWaiters&&) = delete;
+
+    ~SingleFlightWaiters() noexcept { this->complete(detail::InvokeHandler::NO); }
+
+    void operator()() { this->complete(detail::InvokeHandler::YES); }
+
+  private:
+    void complete(detail::InvokeHandler invoke_handler)
+    {
+        while (!this->waiters.empty())
+        {
+            detail::WorkFinishedOnExit on_exit{*this->grpc_context};
+            auto* operation = this->waiters.pop_front();
+            operation->complete(invoke_handler, this->result, this->grpc_context->get_allocator());
+        }
+    }
+
+    agrpc::GrpcContext* grpc_context;
+    detail::SingleFlightWaiterQueue<Result> waiters;
+    std::shared_ptr<const Result> result;
+};
+
+template <class SingleFlight>
+class SingleFlightResolver
+{
+  private:
+    using Key = typename SingleFlight::key_type;
+    using Result = typename SingleFlight::result_type;
+
+  public:
+    SingleFlightResolver(SingleFlight& single_flight, Key key)
+        : single_flight(&single_flight), key(std::move(key))
+    {
+    }
+
+    SingleFlightResolver(SingleFlightResolver&& other) noexcept
+        : single_flight(std::exchange(other.single_flight, nullptr)), key(std::move(other.key))
+    {
+    }
+
+    SingleFlightResolver(const SingleFlightResolver&) = delete;
+    SingleFlightResolver& operator=(const SingleFlightResolver&) = delete;
+    SingleFlightResolver& operator=(SingleFlightResolver&&) = delete;
+
+    ~SingleFlightResolver() noexcept
+    {
+        if (this->single_flight)
+        {
+            this->single_flight->resolve(this->key, nullptr);
+        }
+    }
+
+    void operator()(Result result)
+    {
+        (*this)(std::make_shared<const Result>(std::move(result)));
+    }
+
+    void operator()(std::shared_ptr<const Result> result)
+    {
+        std::exchange(this->single_flight, nullptr)->resolve(this->key, std::move(result));
+    }
+
+  private:
+    SingleFlight* single_flight;
+    Key key;
+};
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_SINGLEFLIGHT_HPP
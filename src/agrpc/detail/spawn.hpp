@@ -0,0 +1,86 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_SPAWN_HPP
+#define AGRPC_DETAIL_SPAWN_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+
+#ifdef AGRPC_STANDALONE_ASIO
+#include <asio/spawn.hpp>
+
+// asio::detail::spawn_data and coro_entry_point were removed when asio::spawn moved to Boost.Context
+#if (ASIO_VERSION >= 102400)
+#error "agrpc::spawn requires the Boost.Coroutine based asio::spawn of Asio 1.23 or earlier"
+#endif
+#elif defined(AGRPC_BOOST_ASIO)
+#include <boost/asio/spawn.hpp>
+
+// boost::asio::detail::spawn_data and coro_entry_point were removed when asio::spawn moved to Boost.Context
+#if (BOOST_VERSION >= 108000)
+#error "agrpc::spawn requires the Boost.Coroutine based asio::spawn of Boost 1.79 or earlier"
+#endif
+#endif
+
+#include <boost/coroutine/attributes.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc::detail
+{
+// Counterpart of asio::detail::spawn_helper that hands a stack allocator to the coroutine
+template <class Handler, class Function, class StackAllocator>
+struct SpawnWithStackAllocator
+{
+    using executor_type = asio::associated_executor_t<Handler>;
+    using Data = asio::detail::spawn_data<Handler, Function>;
+
+    std::shared_ptr<Data> data;
+    StackAllocator stack_allocator;
+    std::size_t stack_size;
+
+    void operator()()
+    {
+        using Coroutine = typename asio::basic_yield_context<Handler>::callee_type;
+        asio::detail::coro_entry_point<Handler, Function> entry_point{this->data};
+        std::shared_ptr<Coroutine> coroutine{new Coroutine(std::move(entry_point),
+                                                           boost::coroutines::attributes(this->stack_size),
+                                                           std::move(this->stack_allocator))};
+        this->data->coro_ = coroutine;
+        (*coroutine)();
+    }
+
+    [[nodiscard]] executor_type get_executor() const noexcept
+    {
+        return asio::get_associated_executor(this->data->handler_);
+    }
+};
+
+template <class Handler, class Function, class StackAllocator>
+void spawn_with_stack_allocator(Handler handler, Function function, StackAllocator stack_allocator,
+                                std::size_t stack_size)
+{
+    using Data = asio::detail::spawn_data<Handler, Function>;
+    auto executor = asio::get_associated_executor(handler);
+    auto data = std::make_shared<Data>(std::move(handler), true, std::move(function));
+    asio::dispatch(executor, detail::SpawnWithStackAllocator<Handler, Function, StackAllocator>{
+                                 std::move(data), std::move(stack_allocator), stack_size});
+}
+}  // namespace agrpc::detail
+#endif
+
+#endif  // AGRPC_DETAIL_SPAWN_HPP
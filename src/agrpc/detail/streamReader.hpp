@@ -0,0 +1,59 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_STREAMREADER_HPP
+#define AGRPC_DETAIL_STREAMREADER_HPP
+
+#include "agrpc/detail/typeErasedOperation.hpp"
+
+#include <grpcpp/support/async_stream.h>
+
+namespace agrpc::detail
+{
+template <class Reader>
+struct ReaderMessage;
+
+template <class Response, class Request>
+struct ReaderMessage<grpc::ServerAsyncReader<Response, Request>>
+{
+    using Type = Request;
+};
+
+template <class Response, class Request>
+struct ReaderMessage<grpc::ServerAsyncReaderWriter<Response, Request>>
+{
+    using Type = Request;
+};
+
+template <class Response>
+struct ReaderMessage<grpc::ClientAsyncReader<Response>>
+{
+    using Type = Response;
+};
+
+template <class Request, class Response>
+struct ReaderMessage<grpc::ClientAsyncReaderWriter<Request, Response>>
+{
+    using Type = Response;
+};
+
+template <class Reader>
+using ReaderMessageT = typename detail::ReaderMessage<Reader>::Type;
+
+template <class Message>
+using StreamReaderOperation = detail::TypeErasedOperation<false, Message*, detail::GrpcContextLocalAllocator>;
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_STREAMREADER_HPP
@@ -0,0 +1,75 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_DETAIL_STREAMWRITER_HPP
+#define AGRPC_DETAIL_STREAMWRITER_HPP
+
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/intrusiveQueue.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+
+#include <grpcpp/support/async_stream.h>
+
+namespace agrpc::detail
+{
+template <class Writer>
+struct WriterMessage;
+
+template <class Response>
+struct WriterMessage<grpc::ServerAsyncWriter<Response>>
+{
+    using Type = Response;
+};
+
+template <class Response, class Request>
+struct WriterMessage<grpc::ServerAsyncReaderWriter<Response, Request>>
+{
+    using Type = Response;
+};
+
+template <class Request>
+struct WriterMessage<grpc::ClientAsyncWriter<Request>>
+{
+    using Type = Request;
+};
+
+template <class Request, class Response>
+struct WriterMessage<grpc::ClientAsyncReaderWriter<Request, Response>>
+{
+    using Type = Request;
+};
+
+template <class Writer>
+using WriterMessageT = typename detail::WriterMessage<Writer>::Type;
+
+using StreamWriterOperation = detail::TypeErasedOperation<true, bool, detail::GrpcContextLocalAllocator>;
+
+using StreamWriterOperationQueue = detail::IntrusiveQueue<detail::StreamWriterOperation>;
+
+inline void complete_stream_writer_operations(agrpc::GrpcContext& grpc_context,
+                                              detail::StreamWriterOperationQueue& operations,
+                                              detail::InvokeHandler invoke_handler, bool ok)
+{
+    while (!operations.empty())
+    {
+        detail::WorkFinishedOnExit on_exit{grpc_context};
+        auto* operation = operations.pop_front();
+        operation->complete(invoke_handler, ok, grpc_context.get_allocator());
+    }
+}
+}  // namespace agrpc::detail
+
+#endif  // AGRPC_DETAIL_STREAMWRITER_HPP
@@ -0,0 +1,284 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_DETAIL_TASK_HPP
+#define AGRPC_DETAIL_TASK_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/attributes.hpp"
+#include "agrpc/detail/grpcContext.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/initiate.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+#include <coroutine>
+
+namespace agrpc::detail
+{
+// Every frame starts with a header that remembers where its memory came from, so that frames created outside of a
+// GrpcContext can still be destroyed inside of one and vice versa
+struct alignas(std::max_align_t) TaskFrameHeader
+{
+    detail::GrpcContextLocalMemoryResource* resource;
+#ifndef NDEBUG
+    std::thread::id thread;
+#endif
+};
+
+inline void* allocate_task_frame(std::size_t size)
+{
+    auto* resource = detail::GrpcContextImplementation::local_resource_of_this_thread();
+    const auto total_size = sizeof(detail::TaskFrameHeader) + size;
+    void* memory = resource != nullptr ? resource->allocate(total_size, alignof(detail::TaskFrameHeader))
+                                       : ::operator new(total_size);
+    auto* header = ::new (memory) detail::TaskFrameHeader{resource};
+#ifndef NDEBUG
+    header->thread = std::this_thread::get_id();
+#endif
+    return header + 1;
+}
+
+inline void deallocate_task_frame(void* frame, std::size_t size) noexcept
+{
+    auto* header = static_cast<detail::TaskFrameHeader*>(frame) - 1;
+    auto* resource = header->resource;
+    const auto total_size = sizeof(detail::TaskFrameHeader) + size;
+    if (resource != nullptr)
+    {
+        // The local memory resource of a GrpcContext is not thread-safe
+        assert(header->thread == std::this_thread::get_id());
+        resource->deallocate(header, total_size, alignof(detail::TaskFrameHeader));
+    }
+    else
+    {
+        ::operator delete(header, total_size);
+    }
+}
+
+struct TaskFinalAwaiter
+{
+    bool await_ready() const noexcept { return false; }
+
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+    {
+        auto continuation = handle.promise().continuation;
+        if (!continuation)
+        {
+            // Detached, see agrpc::spawn_task
+            handle.destroy();
+            return std::noop_coroutine();
+        }
+        return continuation;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+class TaskPromiseBase
+{
+  public:
+    static void* operator new(std::size_t size) { return detail::allocate_task_frame(size); }
+
+    static void operator delete(void* frame, std::size_t size) noexcept { detail::deallocate_task_frame(frame, size); }
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    detail::TaskFinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept { this->exception = std::current_exception(); }
+
+    agrpc::GrpcContext* grpc_context{};
+    std::coroutine_handle<> continuation;
+    std::coroutine_handle<> root;
+    std::exception_ptr exception;
+};
+
+template <class T>
+class TaskPromise : public detail::TaskPromiseBase
+{
+  public:
+    template <class U>
+    void return_value(U&& value)
+    {
+        this->result.emplace(std::forward<U>(value));
+    }
+
+    T get_result()
+    {
+        if (this->exception)
+        {
+            std::rethrow_exception(this->exception);
+        }
+        return std::move(*this->result);
+    }
+
+  private:
+    std::optional<T> result;
+};
+
+template <>
+class TaskPromise<void> : public detail::TaskPromiseBase
+{
+  public:
+    void return_void() const noexcept {}
+
+    void get_result() const
+    {
+        if (this->exception)
+        {
+            std::rethrow_exception(this->exception);
+        }
+    }
+};
+
+// Awaiter for one Task from within another. Resumes the awaited Task through symmetric transfer.
+template <class T, class Promise>
+struct TaskAwaiter
+{
+    std::coroutine_handle<Promise> handle;
+
+    bool await_ready() const noexcept { return false; }
+
+    template <class CallerPromise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<CallerPromise> caller) const noexcept
+    {
+        auto& promise = this->handle.promise();
+        promise.continuation = caller;
+        promise.grpc_context = caller.promise().grpc_context;
+        promise.root = caller.promise().root;
+        return this->handle;
+    }
+
+    T await_resume() const { return this->handle.promise().get_result(); }
+};
+
+template <class Payload>
+struct TaskGrpcTagAwaiterResult
+{
+    Payload payload;
+
+    auto get(bool ok) { return std::pair{std::move(this->payload), ok}; }
+};
+
+template <>
+struct TaskGrpcTagAwaiterResult<void>
+{
+    static bool get(bool ok) noexcept { return ok; }
+};
+
+// The awaiter lives in the frame of the suspended Task and is used directly as the completion queue tag
+template <class Function, class Payload>
+class TaskGrpcTagAwaiter : public detail::TypeErasedGrpcTagOperation,
+                           private detail::TaskGrpcTagAwaiterResult<Payload>
+{
+  public:
+    explicit TaskGrpcTagAwaiter(Function function)
+        : detail::TypeErasedGrpcTagOperation(&TaskGrpcTagAwaiter::do_complete), function(std::move(function))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        auto& promise = handle.promise();
+        auto& grpc_context = *promise.grpc_context;
+        if (grpc_context.is_stopped()) AGRPC_UNLIKELY
+            {
+                return false;
+            }
+        this->handle = handle;
+        this->root = promise.root;
+        grpc_context.work_started();
+        detail::WorkFinishedOnExit on_exit{grpc_context};
+        std::move(this->function)(grpc_context, this);
+        on_exit.release();
+        return true;
+    }
+
+    decltype(auto) await_resume() { return detail::TaskGrpcTagAwaiterResult<Payload>::get(this->ok); }
+
+    // For detail::grpc_initiate_with_payload
+    [[nodiscard]] detail::TaskGrpcTagAwaiterResult<Payload>& handler() noexcept { return *this; }
+
+  private:
+    static void do_complete(detail::TypeErasedGrpcTagOperation* op, detail::InvokeHandler invoke_handler, bool ok,
+                            detail::GrpcContextLocalAllocator)
+    {
+        auto* self = static_cast<TaskGrpcTagAwaiter*>(op);
+        if (detail::InvokeHandler::YES == invoke_handler)
+        {
+            self->ok = ok;
+            self->handle.resume();
+        }
+        else
+        {
+            // The GrpcContext is shutting down, destroying the root frame destroys the whole chain of awaiting Tasks
+            self->root.destroy();
+        }
+    }
+
+    Function function;
+    std::coroutine_handle<> handle;
+    std::coroutine_handle<> root;
+    bool ok{};
+};
+
+// Only operations that are initiated through grpc_initiate can be awaited with agrpc::use_task
+template <class Initiation>
+struct TaskAwaiterFactory;
+
+template <class Function>
+struct TaskAwaiterFactory<detail::GrpcInitiator<Function>>
+{
+    static auto create(detail::GrpcInitiator<Function>&& initiation)
+    {
+        return detail::TaskGrpcTagAwaiter<Function, void>{std::move(initiation.function)};
+    }
+};
+
+template <class Payload, class Function>
+struct TaskAwaiterFactory<detail::GrpcWithPayloadInitiator<Payload, Function>>
+{
+    static auto create(detail::GrpcWithPayloadInitiator<Payload, Function>&& initiation)
+    {
+        return detail::TaskGrpcTagAwaiter<Function, Payload>{std::move(initiation.function)};
+    }
+};
+
+struct UseTaskAsyncResult
+{
+    template <class Initiation, class CompletionToken, class... Args>
+    static auto initiate(Initiation&& initiation, CompletionToken&&, Args&&...)
+    {
+        return detail::TaskAwaiterFactory<detail::RemoveCvrefT<Initiation>>::create(
+            std::forward<Initiation>(initiation));
+    }
+};
+}  // namespace agrpc::detail
+#endif
+
+#endif  // AGRPC_DETAIL_TASK_HPP
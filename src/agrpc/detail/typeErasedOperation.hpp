@@ -16,6 +16,7 @@
 #define AGRPC_DETAIL_GRPCCONTEXTOPERATION_HPP
 
 #include "agrpc/detail/grpcContext.hpp"
+#include "agrpc/detail/intrusiveQueue.hpp"
 #include "agrpc/detail/intrusiveQueueHook.hpp"
 #include "agrpc/detail/utility.hpp"
 
@@ -51,6 +52,34 @@ class TypeErasedOperation
 
 using TypeErasedNoArgOperation = detail::TypeErasedOperation<true, detail::GrpcContextLocalAllocator>;
 using TypeErasedGrpcTagOperation = detail::TypeErasedOperation<false, bool, detail::GrpcContextLocalAllocator>;
+using TypeErasedHopOperation = detail::TypeErasedOperation<true>;
+
+// Completions that go to the same executor, other than the GrpcContext's own, while the GrpcContext processes
+// completion queue events that are ready
+class TypeErasedExecutorHopBatch
+{
+  public:
+    void complete(detail::InvokeHandler invoke_handler, detail::GrpcContextLocalAllocator allocator)
+    {
+        this->on_complete(this, invoke_handler, allocator);
+    }
+
+    TypeErasedExecutorHopBatch* next{};
+    const void* executor_type;
+    detail::IntrusiveQueue<detail::TypeErasedHopOperation> operations;
+
+  protected:
+    using OnCompleteFunction = void (*)(TypeErasedExecutorHopBatch*, detail::InvokeHandler,
+                                        detail::GrpcContextLocalAllocator);
+
+    TypeErasedExecutorHopBatch(OnCompleteFunction on_complete, const void* executor_type) noexcept
+        : executor_type(executor_type), on_complete(on_complete)
+    {
+    }
+
+  private:
+    OnCompleteFunction on_complete;
+};
 }  // namespace agrpc::detail
 
 #endif  // AGRPC_DETAIL_GRPCCONTEXTOPERATION_HPP
@@ -0,0 +1,236 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_DUPLEX_HPP
+#define AGRPC_AGRPC_DUPLEX_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/duplex.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/streamReader.hpp"
+#include "agrpc/detail/streamWriter.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+#include "agrpc/rpcs.hpp"
+#include "agrpc/streamWriter.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Runs an independent read loop and write loop over one ClientAsyncReaderWriter or ServerAsyncReaderWriter. On the
+// client, finish() drains queued writes, sends WritesDone and calls Finish once the read loop has ended. On the server,
+// it drains queued writes and calls Finish right away, a Read that is still pending then completes with false. In both
+// cases finish() completes only after the read loop has ended. finish_after_reads() lets the server wait for the
+// read loop to end before draining queued writes and calling Finish. A failed write cancels the RPC so that the read loop
+// ends as well. Must only be used from the thread that runs the GrpcContext, except for write().
+template <class ReaderWriter>
+class Duplex
+{
+  private:
+    using Traits = detail::DuplexTraits<ReaderWriter>;
+
+  public:
+    using read_type = detail::ReaderMessageT<ReaderWriter>;
+    using write_type = detail::WriterMessageT<ReaderWriter>;
+    using context_type = typename Traits::Context;
+
+    Duplex(agrpc::GrpcContext& grpc_context, ReaderWriter& reader_writer, context_type& context,
+           std::size_t high_water_mark = 16)
+        : grpc_context(grpc_context),
+          reader_writer(reader_writer),
+          context(context),
+          writer(grpc_context, reader_writer, high_water_mark)
+    {
+    }
+
+    Duplex(const Duplex&) = delete;
+    Duplex(Duplex&&) = delete;
+    Duplex& operator=(const Duplex&) = delete;
+    Duplex& operator=(Duplex&&) = delete;
+
+    ~Duplex() noexcept
+    {
+        if (this->on_finish)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            this->on_finish->complete(detail::InvokeHandler::NO, false, this->grpc_context.get_allocator());
+        }
+    }
+
+    // Invokes on_message(read_type&) for every message until the peer is done writing.
+    template <class OnMessage>
+    void start_reading(OnMessage on_message)
+    {
+        this->start_reading(std::move(on_message), [] {});
+    }
+
+    // Like start_reading(on_message) but additionally invokes on_done() once the read loop has ended.
+    template <class OnMessage, class OnDone>
+    void start_reading(OnMessage on_message, OnDone on_done)
+    {
+        this->is_reading = true;
+        this->read_next(std::move(on_message), std::move(on_done));
+    }
+
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto write(write_type message, CompletionToken token = {})
+    {
+        return this->writer.write(std::move(message), std::move(token));
+    }
+
+    void cancel() { this->context.TryCancel(); }
+
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto finish(typename Traits::StatusReference status, CompletionToken token = {})
+    {
+        return this->initiate_finish(status, false, token);
+    }
+
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto finish_after_reads(typename Traits::StatusReference status, CompletionToken token = {})
+    {
+        return this->initiate_finish(status, true, token);
+    }
+
+  private:
+    template <class CompletionToken>
+    auto initiate_finish(typename Traits::StatusReference status, bool wait_for_reads, CompletionToken& token)
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [this, &status, wait_for_reads](auto completion_handler)
+            {
+                const auto allocator = asio::get_associated_allocator(completion_handler);
+                auto operation = detail::allocate_operation<false, void(bool)>(
+                    this->grpc_context, std::move(completion_handler), allocator);
+                this->grpc_context.work_started();
+                this->status = Traits::store(status);
+                this->on_finish = operation.get();
+                operation.release();
+                this->is_flush_deferred = wait_for_reads && this->is_reading;
+                if (!this->is_flush_deferred)
+                {
+                    this->flush();
+                }
+            },
+            token);
+    }
+
+    template <class OnMessage, class OnDone>
+    void read_next(OnMessage&& on_message, OnDone&& on_done)
+    {
+        agrpc::read(this->reader_writer, this->read_message,
+                    asio::bind_executor(this->grpc_context,
+                                        [this, on_message = std::move(on_message),
+                                         on_done = std::move(on_done)](bool ok) mutable
+                                        {
+                                            if (ok)
+                                            {
+                                                on_message(this->read_message);
+                                                this->read_next(std::move(on_message), std::move(on_done));
+                                                return;
+                                            }
+                                            this->is_reading = false;
+                                            on_done();
+                                            if (std::exchange(this->is_flush_deferred, false))
+                                            {
+                                                this->flush();
+                                            }
+                                            this->finish_if_done();
+                                            this->complete_finish_if_done();
+                                        }));
+    }
+
+    void flush()
+    {
+        this->writer.flush(asio::bind_executor(this->grpc_context,
+                                               [this](bool ok)
+                                               {
+                                                   this->on_flushed(ok);
+                                               }));
+    }
+
+    void on_flushed(bool ok)
+    {
+        if (!ok)
+        {
+            this->cancel();
+        }
+        else if constexpr (Traits::IS_CLIENT)
+        {
+            agrpc::writes_done(this->reader_writer, asio::bind_executor(this->grpc_context,
+                                                                        [this](bool)
+                                                                        {
+                                                                            this->on_writes_done();
+                                                                        }));
+            return;
+        }
+        this->on_writes_done();
+    }
+
+    void on_writes_done()
+    {
+        this->is_writes_done = true;
+        this->finish_if_done();
+    }
+
+    void finish_if_done()
+    {
+        const auto is_read_done = !Traits::IS_CLIENT || !this->is_reading;
+        if (this->is_writes_done && is_read_done && this->on_finish && !std::exchange(this->is_finish_started, true))
+        {
+            Traits::finish(this->reader_writer, this->status,
+                           asio::bind_executor(this->grpc_context,
+                                               [this](bool ok)
+                                               {
+                                                   this->is_finished = true;
+                                                   this->is_finish_ok = ok;
+                                                   this->complete_finish_if_done();
+                                               }));
+        }
+    }
+
+    void complete_finish_if_done()
+    {
+        if (this->is_finished && !this->is_reading && this->on_finish)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            std::exchange(this->on_finish, nullptr)
+                ->complete(detail::InvokeHandler::YES, this->is_finish_ok, this->grpc_context.get_allocator());
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    ReaderWriter& reader_writer;
+    context_type& context;
+    agrpc::StreamWriter<ReaderWriter> writer;
+    read_type read_message;
+    typename Traits::StatusStorage status{};
+    detail::TypeErasedGrpcTagOperation* on_finish{};
+    bool is_reading{false};
+    bool is_flush_deferred{false};
+    bool is_writes_done{false};
+    bool is_finish_started{false};
+    bool is_finished{false};
+    bool is_finish_ok{false};
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_DUPLEX_HPP
@@ -17,6 +17,7 @@
 
 #include "agrpc/detail/asioForward.hpp"
 #include "agrpc/detail/atomicIntrusiveQueue.hpp"
+#include "agrpc/detail/frameCache.hpp"
 #include "agrpc/detail/grpcContext.hpp"
 #include "agrpc/detail/grpcContextImplementation.hpp"
 #include "agrpc/detail/grpcExecutorOptions.hpp"
@@ -28,6 +29,7 @@
 #include <grpcpp/completion_queue.h>
 
 #include <atomic>
+#include <cstddef>
 #include <thread>
 
 namespace agrpc
@@ -44,7 +46,10 @@ class GrpcContext
     using executor_type = agrpc::BasicGrpcExecutor<std::allocator<void>, detail::GrpcExecutorOptions::DEFAULT>;
     using allocator_type = detail::GrpcContextLocalAllocator;
 
-    explicit GrpcContext(std::unique_ptr<grpc::CompletionQueue> completion_queue);
+    // frame_cache_depth is the number of coroutine frames per size class that agrpc::GrpcAwaitable coroutines running
+    // on this context keep for reuse. Zero disables the cache.
+    explicit GrpcContext(std::unique_ptr<grpc::CompletionQueue> completion_queue,
+                         std::size_t frame_cache_depth = detail::FrameCache::DEFAULT_DEPTH);
 
     ~GrpcContext();
 
@@ -78,8 +83,11 @@ class GrpcContext
     bool check_remote_work{false};
     std::unique_ptr<grpc::CompletionQueue> completion_queue;
     detail::GrpcContextLocalMemoryResource local_resource{detail::pmr::new_delete_resource()};
+    detail::FrameCache frame_cache;
     LocalWorkQueue local_work_queue;
+    LocalWorkQueue idle_work_queue;
     RemoteWorkQueue remote_work_queue{false};
+    detail::TypeErasedExecutorHopBatch* executor_hop_batches{};
 
     friend detail::GrpcContextImplementation;
 };
@@ -61,8 +61,9 @@ inline void drain_completion_queue(agrpc::GrpcContext& grpc_context)
 }
 }  // namespace detail
 
-inline GrpcContext::GrpcContext(std::unique_ptr<grpc::CompletionQueue> completion_queue)
-    : completion_queue(std::move(completion_queue))
+inline GrpcContext::GrpcContext(std::unique_ptr<grpc::CompletionQueue> completion_queue,
+                                std::size_t frame_cache_depth)
+    : completion_queue(std::move(completion_queue)), frame_cache(frame_cache_depth)
 {
 }
 
@@ -71,6 +72,8 @@ inline GrpcContext::~GrpcContext()
     this->stop();
     this->completion_queue->Shutdown();
     detail::drain_completion_queue(*this);
+    detail::GrpcContextImplementation::complete_executor_hops<detail::InvokeHandler::NO>(*this);
+    detail::GrpcContextImplementation::process_idle_queue<detail::InvokeHandler::NO>(*this);
 #if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
     asio::execution_context::shutdown();
     asio::execution_context::destroy();
@@ -101,6 +104,7 @@ inline void GrpcContext::run()
         {
             //
         }
+    detail::GrpcContextImplementation::complete_executor_hops<detail::InvokeHandler::YES>(*this);
 }
 
 inline void GrpcContext::stop()
@@ -16,6 +16,7 @@
 #define AGRPC_AGRPC_GRPCEXECUTOR_HPP
 
 #include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/awaitableFrame.hpp"
 #include "agrpc/detail/grpcContextInteraction.hpp"
 #include "agrpc/detail/grpcExecutorBase.hpp"
 #include "agrpc/detail/grpcExecutorOptions.hpp"
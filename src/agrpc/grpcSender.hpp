@@ -16,56 +16,227 @@
 #define AGRPC_AGRPC_GRPCSENDER_HPP
 
 #include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/attributes.hpp"
 #include "agrpc/detail/grpcContext.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
 #include "agrpc/detail/typeErasedOperation.hpp"
 #include "agrpc/detail/utility.hpp"
 #include "agrpc/grpcContext.hpp"
+#include "agrpc/grpcExecutor.hpp"
 #include "agrpc/rpcs.hpp"
 
-#ifdef AGRPC_UNIFEX
+#include <grpcpp/alarm.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#if defined(AGRPC_UNIFEX) || defined(AGRPC_STDEXEC)
 namespace agrpc
 {
-template <class InitiationFunction>
+namespace detail
+{
+#ifdef AGRPC_UNIFEX
+template <class Receiver>
+using StopTokenTypeT = unifex::stop_token_type_t<Receiver>;
+
+template <class StopToken>
+inline constexpr bool IS_STOP_EVER_POSSIBLE_V = !unifex::is_stop_never_possible_v<StopToken>;
+
+template <class Receiver>
+auto get_stop_token(const Receiver& receiver) noexcept
+{
+    return unifex::get_stop_token(receiver);
+}
+
+template <class Receiver>
+void set_done(Receiver&& receiver) noexcept
+{
+    unifex::set_done(std::forward<Receiver>(receiver));
+}
+
+template <class Receiver, class... Args>
+void satisfy_receiver(Receiver&& receiver, Args&&... args) noexcept
+{
+    if constexpr (noexcept(unifex::set_value(std::forward<Receiver>(receiver), std::forward<Args>(args)...)))
+    {
+        unifex::set_value(std::forward<Receiver>(receiver), std::forward<Args>(args)...);
+    }
+    else
+    {
+        UNIFEX_TRY { unifex::set_value(std::forward<Receiver>(receiver), std::forward<Args>(args)...); }
+        UNIFEX_CATCH(...) { unifex::set_error(std::forward<Receiver>(receiver), std::current_exception()); }
+    }
+}
+#else
+template <class Receiver>
+using StopTokenTypeT = stdexec::stop_token_of_t<stdexec::env_of_t<Receiver>>;
+
+template <class StopToken>
+inline constexpr bool IS_STOP_EVER_POSSIBLE_V = !stdexec::unstoppable_token<StopToken>;
+
+template <class Receiver>
+auto get_stop_token(const Receiver& receiver) noexcept
+{
+    return stdexec::get_stop_token(stdexec::get_env(receiver));
+}
+
+template <class Receiver>
+void set_done(Receiver&& receiver) noexcept
+{
+    stdexec::set_stopped(std::forward<Receiver>(receiver));
+}
+
+template <class Receiver, class... Args>
+void satisfy_receiver(Receiver&& receiver, Args&&... args) noexcept
+{
+    if constexpr (noexcept(stdexec::set_value(std::forward<Receiver>(receiver), std::forward<Args>(args)...)))
+    {
+        stdexec::set_value(std::forward<Receiver>(receiver), std::forward<Args>(args)...);
+    }
+    else
+    {
+        try
+        {
+            stdexec::set_value(std::forward<Receiver>(receiver), std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            stdexec::set_error(std::forward<Receiver>(receiver), std::current_exception());
+        }
+    }
+}
+#endif
+
+struct NoOpStopFunction
+{
+    void operator()() const noexcept {}
+};
+
+template <bool IsStoppable, class StopToken, class OnStop>
+struct StopCallbackStorage
+{
+    using Type = detail::Empty;
+};
+
+template <class StopToken, class OnStop>
+struct StopCallbackStorage<true, StopToken, OnStop>
+{
+    using Type = std::optional<typename StopToken::template callback_type<OnStop>>;
+};
+
+template <bool IsStoppable, class StopToken, class OnStop>
+using StopCallbackStorageT = typename detail::StopCallbackStorage<IsStoppable, StopToken, OnStop>::Type;
+}  // namespace detail
+
+// The StopFunction is invoked when the receiver's stop token is triggered while the operation is in flight, e.g. to
+// call grpc::ClientContext::TryCancel or grpc::Alarm::Cancel
+template <class InitiationFunction, class StopFunction = detail::NoOpStopFunction>
 class GrpcSender
 {
   private:
     template <class Receiver>
     class Operation : private detail::TypeErasedGrpcTagOperation
     {
+      private:
+        struct OnStop
+        {
+            Operation& self;
+
+            void operator()() const noexcept { self.stop_function(); }
+        };
+
+        using StopToken = detail::StopTokenTypeT<Receiver>;
+
+        static constexpr bool IS_STOPPABLE = detail::IS_STOP_EVER_POSSIBLE_V<StopToken> &&
+                                             !std::is_same_v<detail::NoOpStopFunction, StopFunction>;
+
       public:
+#ifdef AGRPC_STDEXEC
+        using operation_state_concept = stdexec::operation_state_t;
+#endif
+
         template <class Receiver2>
         explicit Operation(const GrpcSender& sender, Receiver2&& receiver)
             : detail::TypeErasedGrpcTagOperation(&Operation::on_complete),
               context(sender.context),
               initiation_function(sender.initiation_function),
+              stop_function(sender.stop_function),
               receiver(std::forward<Receiver2>(receiver))
         {
         }
 
-        void start() & noexcept { initiation_function(context, this); }
+        void start() & noexcept
+        {
+            if (this->context.is_stopped()) AGRPC_UNLIKELY
+                {
+                    detail::set_done(std::move(this->receiver));
+                    return;
+                }
+            if constexpr (IS_STOPPABLE)
+            {
+                auto stop_token = detail::get_stop_token(this->receiver);
+                if (stop_token.stop_requested())
+                {
+                    detail::set_done(std::move(this->receiver));
+                    return;
+                }
+                this->initiate();
+                // Registered after initiation for the same reason as in ScheduleAfterSender
+                this->stop_callback.emplace(std::move(stop_token), OnStop{*this});
+            }
+            else
+            {
+                this->initiate();
+            }
+        }
 
       private:
-        static void on_complete(detail::TypeErasedGrpcTagOperation* op, detail::InvokeHandler, bool ok,
+        void initiate()
+        {
+            this->context.work_started();
+            this->initiation_function(this->context, this);
+        }
+
+        static void on_complete(detail::TypeErasedGrpcTagOperation* op, detail::InvokeHandler invoke_handler, bool ok,
                                 detail::GrpcContextLocalAllocator) noexcept
         {
             auto& self = *static_cast<Operation*>(op);
-            if constexpr (noexcept(unifex::set_value(std::move(self.receiver), ok)))
+            if constexpr (IS_STOPPABLE)
             {
-                unifex::set_value(std::move(self.receiver), ok);
+                self.stop_callback.reset();
             }
-            else
+            if (detail::InvokeHandler::NO == invoke_handler)
+            {
+                detail::set_done(std::move(self.receiver));
+                return;
+            }
+            if constexpr (IS_STOPPABLE)
             {
-                UNIFEX_TRY { unifex::set_value(std::move(self.receiver), ok); }
-                UNIFEX_CATCH(...) { unifex::set_error(std::move(self.receiver), std::current_exception()); }
+                if (!ok && detail::get_stop_token(self.receiver).stop_requested())
+                {
+                    detail::set_done(std::move(self.receiver));
+                    return;
+                }
             }
+            detail::satisfy_receiver(std::move(self.receiver), ok);
         }
 
         agrpc::GrpcContext& context;
         InitiationFunction initiation_function;
+        StopFunction stop_function;
         Receiver receiver;
+        detail::StopCallbackStorageT<IS_STOPPABLE, StopToken, OnStop> stop_callback;
     };
 
   public:
+#ifdef AGRPC_UNIFEX
     template <template <class...> class Variant, template <class...> class Tuple>
     using value_types = Variant<Tuple<bool>>;
 
@@ -75,9 +246,19 @@ class GrpcSender
     using error_types = Variant<std::error_code, std::exception_ptr>;
 
     static constexpr bool sends_done = true;
+#else
+    using sender_concept = stdexec::sender_t;
+
+    using completion_signatures =
+        stdexec::completion_signatures<stdexec::set_value_t(bool), stdexec::set_error_t(std::exception_ptr),
+                                       stdexec::set_stopped_t()>;
+#endif
 
-    explicit GrpcSender(agrpc::GrpcContext& context, InitiationFunction initiation_function) noexcept
-        : context(context), initiation_function(std::move(initiation_function))
+    explicit GrpcSender(agrpc::GrpcContext& context, InitiationFunction initiation_function,
+                        StopFunction stop_function = {}) noexcept
+        : context(context),
+          initiation_function(std::move(initiation_function)),
+          stop_function(std::move(stop_function))
     {
     }
 
@@ -90,10 +271,260 @@ class GrpcSender
   private:
     agrpc::GrpcContext& context;
     InitiationFunction initiation_function;
+    StopFunction stop_function;
+};
+
+class ScheduleSender
+{
+  private:
+    template <class Receiver>
+    class Operation : private detail::TypeErasedNoArgOperation
+    {
+      public:
+#ifdef AGRPC_STDEXEC
+        using operation_state_concept = stdexec::operation_state_t;
+#endif
+
+        template <class Receiver2>
+        explicit Operation(const ScheduleSender& sender, Receiver2&& receiver)
+            : detail::TypeErasedNoArgOperation(&Operation::on_complete),
+              grpc_context(sender.grpc_context),
+              receiver(std::forward<Receiver2>(receiver))
+        {
+        }
+
+        void start() & noexcept
+        {
+            if (this->grpc_context.is_stopped()) AGRPC_UNLIKELY
+                {
+                    detail::set_done(std::move(this->receiver));
+                    return;
+                }
+            if (detail::GrpcContextImplementation::running_in_this_thread(this->grpc_context))
+            {
+                detail::GrpcContextImplementation::add_local_operation(this->grpc_context, this);
+            }
+            else
+            {
+                detail::GrpcContextImplementation::add_remote_operation(this->grpc_context, this);
+            }
+        }
+
+      private:
+        static void on_complete(detail::TypeErasedNoArgOperation* op, detail::InvokeHandler invoke_handler,
+                                detail::GrpcContextLocalAllocator) noexcept
+        {
+            auto& self = *static_cast<Operation*>(op);
+            if (detail::InvokeHandler::YES == invoke_handler)
+            {
+                detail::satisfy_receiver(std::move(self.receiver));
+            }
+            else
+            {
+                detail::set_done(std::move(self.receiver));
+            }
+        }
+
+        agrpc::GrpcContext& grpc_context;
+        Receiver receiver;
+    };
+
+#ifdef AGRPC_STDEXEC
+    struct Env
+    {
+        agrpc::GrpcContext& grpc_context;
+
+        template <class CPO>
+        [[nodiscard]] agrpc::GrpcExecutor query(stdexec::get_completion_scheduler_t<CPO>) const noexcept
+        {
+            return this->grpc_context.get_executor();
+        }
+    };
+#endif
+
+  public:
+#ifdef AGRPC_UNIFEX
+    template <template <class...> class Variant, template <class...> class Tuple>
+    using value_types = Variant<Tuple<>>;
+
+    template <template <class...> class Variant>
+    using error_types = Variant<std::exception_ptr>;
+
+    static constexpr bool sends_done = true;
+#else
+    using sender_concept = stdexec::sender_t;
+
+    using completion_signatures =
+        stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_error_t(std::exception_ptr),
+                                       stdexec::set_stopped_t()>;
+#endif
+
+    explicit ScheduleSender(agrpc::GrpcContext& grpc_context) noexcept : grpc_context(grpc_context) {}
+
+    template <class Receiver>
+    Operation<detail::RemoveCvrefT<Receiver>> connect(Receiver&& receiver) const
+    {
+        return Operation<detail::RemoveCvrefT<Receiver>>{*this, std::forward<Receiver>(receiver)};
+    }
+
+#ifdef AGRPC_STDEXEC
+    [[nodiscard]] Env get_env() const noexcept { return {this->grpc_context}; }
+#endif
+
+  private:
+    agrpc::GrpcContext& grpc_context;
 };
 
+// A BasicGrpcExecutor is the scheduler of a GrpcContext
+template <class Allocator, std::uint32_t Options>
+auto tag_invoke(detail::exec::tag_t<detail::exec::schedule>,
+                const agrpc::BasicGrpcExecutor<Allocator, Options>& executor) noexcept
+{
+    return agrpc::ScheduleSender{executor.context()};
+}
+
+#ifdef AGRPC_UNIFEX
+template <class Duration>
+class ScheduleAfterSender
+{
+  private:
+    template <class Receiver>
+    class Operation : private detail::TypeErasedGrpcTagOperation
+    {
+      private:
+        struct OnStop
+        {
+            grpc::Alarm& alarm;
+
+            void operator()() const noexcept { alarm.Cancel(); }
+        };
+
+        using StopToken = detail::StopTokenTypeT<Receiver>;
+
+        static constexpr bool IS_STOPPABLE = detail::IS_STOP_EVER_POSSIBLE_V<StopToken>;
+
+      public:
+        template <class Receiver2>
+        explicit Operation(const ScheduleAfterSender& sender, Receiver2&& receiver)
+            : detail::TypeErasedGrpcTagOperation(&Operation::on_complete),
+              grpc_context(sender.grpc_context),
+              duration(sender.duration),
+              receiver(std::forward<Receiver2>(receiver))
+        {
+        }
+
+        void start() & noexcept
+        {
+            if (this->grpc_context.is_stopped()) AGRPC_UNLIKELY
+                {
+                    detail::set_done(std::move(this->receiver));
+                    return;
+                }
+            if constexpr (IS_STOPPABLE)
+            {
+                auto stop_token = detail::get_stop_token(this->receiver);
+                if (stop_token.stop_requested())
+                {
+                    detail::set_done(std::move(this->receiver));
+                    return;
+                }
+                this->set_alarm();
+                // Registered after the alarm has been set, a stop request that arrives in between would otherwise
+                // cancel an alarm that is not set yet
+                this->stop_callback.emplace(std::move(stop_token), OnStop{this->alarm});
+            }
+            else
+            {
+                this->set_alarm();
+            }
+        }
+
+      private:
+        void set_alarm()
+        {
+            this->grpc_context.work_started();
+            this->alarm.Set(this->grpc_context.get_completion_queue(),
+                            std::chrono::system_clock::now() + this->duration, this);
+        }
+
+        static void on_complete(detail::TypeErasedGrpcTagOperation* op, detail::InvokeHandler invoke_handler, bool ok,
+                                detail::GrpcContextLocalAllocator) noexcept
+        {
+            auto& self = *static_cast<Operation*>(op);
+            if constexpr (IS_STOPPABLE)
+            {
+                self.stop_callback.reset();
+            }
+            if (detail::InvokeHandler::YES == invoke_handler && ok)
+            {
+                detail::satisfy_receiver(std::move(self.receiver));
+            }
+            else
+            {
+                detail::set_done(std::move(self.receiver));
+            }
+        }
+
+        agrpc::GrpcContext& grpc_context;
+        Duration duration;
+        grpc::Alarm alarm;
+        Receiver receiver;
+        detail::StopCallbackStorageT<IS_STOPPABLE, StopToken, OnStop> stop_callback;
+    };
+
+  public:
+    template <template <class...> class Variant, template <class...> class Tuple>
+    using value_types = Variant<Tuple<>>;
+
+    template <template <class...> class Variant>
+    using error_types = Variant<std::exception_ptr>;
+
+    static constexpr bool sends_done = true;
+
+    explicit ScheduleAfterSender(agrpc::GrpcContext& grpc_context, const Duration& duration) noexcept
+        : grpc_context(grpc_context), duration(duration)
+    {
+    }
+
+    template <class Receiver>
+    Operation<detail::RemoveCvrefT<Receiver>> connect(Receiver&& receiver) const
+    {
+        return Operation<detail::RemoveCvrefT<Receiver>>{*this, std::forward<Receiver>(receiver)};
+    }
+
+  private:
+    agrpc::GrpcContext& grpc_context;
+    Duration duration;
+};
+
+template <class Allocator, std::uint32_t Options, class Rep, class Period>
+auto tag_invoke(unifex::tag_t<unifex::schedule_after>, const agrpc::BasicGrpcExecutor<Allocator, Options>& executor,
+                const std::chrono::duration<Rep, Period>& duration) noexcept
+{
+    return agrpc::ScheduleAfterSender<std::chrono::duration<Rep, Period>>{executor.context(), duration};
+}
+#endif
+
+template <class Scheduler, class Deadline>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_wait>, Scheduler scheduler, grpc::Alarm& alarm,
+                const Deadline& deadline) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, deadline](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 alarm.Set(grpc_context.get_completion_queue(), deadline, tag);
+                             },
+                             [&alarm]
+                             {
+                                 alarm.Cancel();
+                             });
+}
+
+/*
+Server
+*/
 template <class Scheduler, class RPC, class Service, class Request, class Responder>
-auto tag_invoke(unifex::tag_t<agrpc::async_request>, Scheduler scheduler,
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler,
                 detail::ServerMultiArgRequest<RPC, Request, Responder> rpc, Service& service,
                 grpc::ServerContext& server_context, Request& request, Responder& responder) noexcept
 {
@@ -105,8 +536,124 @@ auto tag_invoke(unifex::tag_t<agrpc::async_request>, Scheduler scheduler,
                              });
 }
 
+template <class Scheduler, class RPC, class Service, class Responder>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler,
+                detail::ServerSingleArgRequest<RPC, Responder> rpc, Service& service,
+                grpc::ServerContext& server_context, Responder& responder) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, rpc](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 auto* cq = grpc_context.get_server_completion_queue();
+                                 (service.*rpc)(&server_context, &responder, cq, cq, tag);
+                             });
+}
+
+template <class Scheduler>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler, grpc::AsyncGenericService& service,
+                grpc::GenericServerContext& server_context,
+                grpc::GenericServerAsyncReaderWriter& reader_writer) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 auto* cq = grpc_context.get_server_completion_queue();
+                                 service.RequestCall(&server_context, &reader_writer, cq, cq, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_read>, Scheduler scheduler,
+                grpc::ServerAsyncReader<Response, Request>& reader, Request& request) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader.Read(&request, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_read>, Scheduler scheduler,
+                grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, Request& request) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Read(&request, tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler, grpc::ServerAsyncWriter<Response>& writer,
+                const Response& response) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.Write(response, tag);
+                             });
+}
+
 template <class Scheduler, class Response>
-auto tag_invoke(unifex::tag_t<agrpc::async_finish>, Scheduler scheduler,
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler, grpc::ServerAsyncWriter<Response>& writer,
+                const Response& response, grpc::WriteOptions options) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, options](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.Write(response, options, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler,
+                grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const Response& response) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Write(response, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler,
+                grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const Response& response,
+                grpc::WriteOptions options) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, options](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Write(response, options, tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
+                grpc::ServerAsyncWriter<Response>& writer, const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.Finish(status, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
+                grpc::ServerAsyncReader<Response, Request>& reader, const Response& response,
+                const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader.Finish(response, status, tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
                 grpc::ServerAsyncResponseWriter<Response>& writer, const Response& response,
                 const grpc::Status& status) noexcept
 {
@@ -117,8 +664,258 @@ auto tag_invoke(unifex::tag_t<agrpc::async_finish>, Scheduler scheduler,
                              });
 }
 
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
+                grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Finish(status, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write_and_finish>, Scheduler scheduler,
+                grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const Response& response,
+                grpc::WriteOptions options, const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, options](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.WriteAndFinish(response, options, status, tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write_and_finish>, Scheduler scheduler,
+                grpc::ServerAsyncWriter<Response>& writer, const Response& response, grpc::WriteOptions options,
+                const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, options](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.WriteAndFinish(response, options, status, tag);
+                             });
+}
+
+template <class Scheduler, class Response, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish_with_error>, Scheduler scheduler,
+                grpc::ServerAsyncReader<Response, Request>& reader, const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader.FinishWithError(status, tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish_with_error>, Scheduler scheduler,
+                grpc::ServerAsyncResponseWriter<Response>& writer, const grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.FinishWithError(status, tag);
+                             });
+}
+
+template <class Scheduler, class Responder>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_send_initial_metadata>, Scheduler scheduler,
+                Responder& responder) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 responder.SendInitialMetadata(tag);
+                             });
+}
+
+/*
+Client
+*/
+template <class Scheduler, class RPC, class Stub, class Request, class Reader>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler,
+                detail::ClientServerStreamingRequest<RPC, Request, Reader> rpc, Stub& stub,
+                grpc::ClientContext& client_context, const Request& request, Reader& reader) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, rpc](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 reader = (stub.*rpc)(&client_context, request, grpc_context.get_completion_queue(),
+                                                      tag);
+                             },
+                             [&client_context]
+                             {
+                                 client_context.TryCancel();
+                             });
+}
+
+template <class Scheduler, class RPC, class Stub, class Writer, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler,
+                detail::ClientSideStreamingRequest<RPC, Writer, Response> rpc, Stub& stub,
+                grpc::ClientContext& client_context, Writer& writer, Response& response) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, rpc](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 writer = (stub.*rpc)(&client_context, &response, grpc_context.get_completion_queue(),
+                                                      tag);
+                             },
+                             [&client_context]
+                             {
+                                 client_context.TryCancel();
+                             });
+}
+
+template <class Scheduler, class RPC, class Stub, class ReaderWriter>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler,
+                detail::ClientBidirectionalStreamingRequest<RPC, ReaderWriter> rpc, Stub& stub,
+                grpc::ClientContext& client_context, ReaderWriter& reader_writer) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, rpc](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 reader_writer = (stub.*rpc)(&client_context, grpc_context.get_completion_queue(), tag);
+                             },
+                             [&client_context]
+                             {
+                                 client_context.TryCancel();
+                             });
+}
+
+template <class Scheduler>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_request>, Scheduler scheduler, const std::string& method,
+                grpc::GenericStub& stub, grpc::ClientContext& client_context,
+                std::unique_ptr<grpc::GenericClientAsyncReaderWriter>& reader_writer) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](agrpc::GrpcContext& grpc_context, void* tag)
+                             {
+                                 reader_writer =
+                                     stub.PrepareCall(&client_context, method, grpc_context.get_completion_queue());
+                                 reader_writer->StartCall(tag);
+                             },
+                             [&client_context]
+                             {
+                                 client_context.TryCancel();
+                             });
+}
+
 template <class Scheduler, class Response>
-auto tag_invoke(unifex::tag_t<agrpc::async_finish>, Scheduler scheduler,
+auto tag_invoke(detail::exec::tag_t<agrpc::async_read>, Scheduler scheduler, grpc::ClientAsyncReader<Response>& reader,
+                Response& response) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader.Read(&response, tag);
+                             });
+}
+
+template <class Scheduler, class Request, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_read>, Scheduler scheduler,
+                grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, Response& response) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Read(&response, tag);
+                             });
+}
+
+template <class Scheduler, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler, grpc::ClientAsyncWriter<Request>& writer,
+                const Request& request) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.Write(request, tag);
+                             });
+}
+
+template <class Scheduler, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler, grpc::ClientAsyncWriter<Request>& writer,
+                const Request& request, grpc::WriteOptions options) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, options](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.Write(request, options, tag);
+                             });
+}
+
+template <class Scheduler, class Request, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler,
+                grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, const Request& request) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Write(request, tag);
+                             });
+}
+
+template <class Scheduler, class Request, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_write>, Scheduler scheduler,
+                grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, const Request& request,
+                grpc::WriteOptions options) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&, options](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Write(request, options, tag);
+                             });
+}
+
+template <class Scheduler, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_writes_done>, Scheduler scheduler,
+                grpc::ClientAsyncWriter<Request>& writer) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.WritesDone(tag);
+                             });
+}
+
+template <class Scheduler, class Request, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_writes_done>, Scheduler scheduler,
+                grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.WritesDone(tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
+                grpc::ClientAsyncReader<Response>& reader, grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader.Finish(&status, tag);
+                             });
+}
+
+template <class Scheduler, class Request>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler, grpc::ClientAsyncWriter<Request>& writer,
+                grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 writer.Finish(&status, tag);
+                             });
+}
+
+template <class Scheduler, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
                 grpc::ClientAsyncResponseReader<Response>& reader, Response& response, grpc::Status& status) noexcept
 {
     return agrpc::GrpcSender(scheduler.context(),
@@ -127,6 +924,28 @@ auto tag_invoke(unifex::tag_t<agrpc::async_finish>, Scheduler scheduler,
                                  reader.Finish(&response, &status, tag);
                              });
 }
+
+template <class Scheduler, class Request, class Response>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_finish>, Scheduler scheduler,
+                grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, grpc::Status& status) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 reader_writer.Finish(&status, tag);
+                             });
+}
+
+template <class Scheduler, class Responder>
+auto tag_invoke(detail::exec::tag_t<agrpc::async_read_initial_metadata>, Scheduler scheduler,
+                Responder& responder) noexcept
+{
+    return agrpc::GrpcSender(scheduler.context(),
+                             [&](const agrpc::GrpcContext&, void* tag)
+                             {
+                                 responder.ReadInitialMetadata(tag);
+                             });
+}
 }  // namespace agrpc
 #endif
 
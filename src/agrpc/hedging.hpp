@@ -0,0 +1,117 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_HEDGING_HPP
+#define AGRPC_AGRPC_HEDGING_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/hedging.hpp"
+#include "agrpc/detail/initiate.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+
+#include <grpcpp/support/status.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace agrpc
+{
+// Keeps a sliding window of observed latencies and derives the hedging delay from the configured percentile of it.
+class LatencyTracker
+{
+  public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    explicit LatencyTracker(double percentile = 0.95, std::size_t window_size = 1024,
+                            Duration initial_delay = std::chrono::milliseconds(10))
+        : percentile(percentile), window_size(window_size), cached_delay(initial_delay)
+    {
+        this->samples.reserve(window_size);
+    }
+
+    void record(Duration latency)
+    {
+        if (this->samples.size() < this->window_size)
+        {
+            this->samples.push_back(latency);
+        }
+        else
+        {
+            this->samples[this->next_sample] = latency;
+        }
+        this->next_sample = (this->next_sample + 1) % this->window_size;
+        this->is_delay_outdated = true;
+    }
+
+    [[nodiscard]] Duration delay()
+    {
+        if (this->is_delay_outdated)
+        {
+            this->sorted_samples = this->samples;
+            const auto index = static_cast<std::size_t>(this->percentile * (this->sorted_samples.size() - 1));
+            const auto nth = this->sorted_samples.begin() + static_cast<std::ptrdiff_t>(index);
+            std::nth_element(this->sorted_samples.begin(), nth, this->sorted_samples.end());
+            this->cached_delay = *nth;
+            this->is_delay_outdated = false;
+        }
+        return this->cached_delay;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->samples.size(); }
+
+  private:
+    double percentile;
+    std::size_t window_size;
+    std::size_t next_sample{};
+    Duration cached_delay;
+    std::vector<Duration> samples;
+    std::vector<Duration> sorted_samples;
+    bool is_delay_outdated{false};
+};
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Starts a unary call and, whenever no reply arrived within latency_tracker.delay(), another copy of it, up to
+// max_attempts in total. start_call(grpc::ClientContext&, grpc::CompletionQueue*, std::size_t attempt) must return the
+// std::unique_ptr<grpc::ClientAsyncResponseReader<Response>> of the started call. The first successful reply wins and
+// is moved into response and status, all other attempts are cancelled with grpc::ClientContext::TryCancel. Must be
+// initiated from the thread that runs the GrpcContext.
+template <class Response, class StartCall, class CompletionToken = agrpc::DefaultCompletionToken>
+auto hedged_request(agrpc::LatencyTracker& latency_tracker, std::size_t max_attempts, StartCall start_call,
+                    Response& response, grpc::Status& status, CompletionToken token = {})
+{
+    return asio::async_initiate<CompletionToken, void(bool)>(
+        [&](auto completion_handler, StartCall start_call)
+        {
+            const auto [executor, allocator] = detail::get_associated_executor_and_allocator(completion_handler);
+            auto& grpc_context = detail::query_grpc_context(executor);
+            auto operation =
+                detail::allocate_operation<false, void(bool)>(grpc_context, std::move(completion_handler), allocator);
+            grpc_context.work_started();
+            auto call = std::allocate_shared<detail::HedgedCall<Response, StartCall, agrpc::LatencyTracker>>(
+                grpc_context.get_allocator(), grpc_context, latency_tracker, max_attempts, std::move(start_call),
+                response, status, operation.get());
+            operation.release();
+            call->start_attempt();
+        },
+        token, std::move(start_call));
+}
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_HEDGING_HPP
@@ -16,7 +16,10 @@
 #define AGRPC_AGRPC_INITIATE_HPP
 
 #include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
 #include "agrpc/detail/initiate.hpp"
+#include "agrpc/grpcContext.hpp"
 #include "agrpc/grpcExecutor.hpp"
 
 namespace agrpc
@@ -52,6 +55,24 @@ static constexpr agrpc::pmr::GrpcUseAwaitable GRPC_USE_AWAITABLE{};
 }  // namespace pmr
 
 using DefaultCompletionToken = asio::use_awaitable_t<>;
+
+// Completion token for asio::awaitable coroutines that stores the completion queue tag in the frame of the awaiting
+// coroutine instead of allocating an operation for every RPC step. Only operations with a void(bool) signature that
+// are initiated through agrpc::grpc_initiate in a coroutine whose executor is a GrpcExecutor complete inline. All
+// other operations, e.g. client streaming requests that complete with the responder, and coroutines running on other
+// executors, including strands of a GrpcContext, fall back to asio::use_awaitable. Inline operations cannot be
+// cancelled through the coroutine's cancellation slot.
+template <class Executor = asio::any_io_executor>
+struct UseAwaitableInline
+{
+    constexpr UseAwaitableInline() noexcept = default;
+};
+
+inline constexpr agrpc::UseAwaitableInline<> use_awaitable_inline{};
+
+using GrpcUseAwaitableInline = agrpc::UseAwaitableInline<agrpc::GrpcExecutor>;
+
+static constexpr agrpc::GrpcUseAwaitableInline GRPC_USE_AWAITABLE_INLINE{};
 #else
 using DefaultCompletionToken = detail::DefaultCompletionTokenNotAvailable;
 #endif
@@ -62,6 +83,24 @@ auto grpc_initiate(Function function, CompletionToken token = {})
     return asio::async_initiate<CompletionToken, void(bool)>(detail::GrpcInitiator{std::move(function)}, token);
 }
 
+// Completes once the GrpcContext has run all of its ready work and is about to wait for the next completion queue
+// event, which makes it a natural point to flush work that was corked during a burst. Operations initiated from the
+// completion handler complete in the next iteration. Must be initiated from the thread that runs the GrpcContext.
+template <class CompletionToken = agrpc::DefaultCompletionToken>
+auto when_idle(agrpc::GrpcContext& grpc_context, CompletionToken token = {})
+{
+    return asio::async_initiate<CompletionToken, void()>(
+        [&](auto completion_handler)
+        {
+            const auto allocator = asio::get_associated_allocator(completion_handler);
+            auto operation =
+                detail::allocate_operation<true, void()>(grpc_context, std::move(completion_handler), allocator);
+            detail::GrpcContextImplementation::add_idle_operation(grpc_context, operation.get());
+            operation.release();
+        },
+        token);
+}
+
 [[nodiscard]] inline auto get_completion_queue(const asio::any_io_executor& executor) noexcept
 {
     return detail::query_grpc_context(executor).get_completion_queue();
@@ -86,4 +125,26 @@ template <class Executor = asio::any_io_executor>
 #endif
 }  // namespace agrpc
 
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+#ifdef AGRPC_STANDALONE_ASIO
+namespace asio
+{
+template <class Executor, class Signature>
+class async_result<::agrpc::UseAwaitableInline<Executor>, Signature>
+    : public ::agrpc::detail::UseAwaitableInlineAsyncResult<Executor, Signature>
+{
+};
+}  // namespace asio
+#elif defined(AGRPC_BOOST_ASIO)
+namespace boost::asio
+{
+template <class Executor, class Signature>
+class async_result<::agrpc::UseAwaitableInline<Executor>, Signature>
+    : public ::agrpc::detail::UseAwaitableInlineAsyncResult<Executor, Signature>
+{
+};
+}  // namespace boost::asio
+#endif
+#endif
+
 #endif  // AGRPC_AGRPC_INITIATE_HPP
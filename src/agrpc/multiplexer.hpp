@@ -0,0 +1,259 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_MULTIPLEXER_HPP
+#define AGRPC_AGRPC_MULTIPLEXER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/initiate.hpp"
+#include "agrpc/detail/multiplexer.hpp"
+#include "agrpc/detail/typeErasedOperation.hpp"
+#include "agrpc/duplex.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+
+#include <grpcpp/client_context.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <grpcpp/support/status.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Carries many concurrent request/response pairs over one long-lived bidirectional stream of grpc::ByteBuffer.
+// Every message is prefixed with a 64-bit correlation id which the MultiplexedServer echoes in its response, so
+// responses may arrive in any order. Calls that are still pending when the stream ends complete with false. Must only
+// be used from the thread that runs the GrpcContext.
+template <class Request, class Response>
+class MultiplexedClient
+{
+  public:
+    MultiplexedClient(agrpc::GrpcContext& grpc_context, grpc::GenericClientAsyncReaderWriter& reader_writer,
+                      grpc::ClientContext& client_context,
+                      std::size_t high_water_mark = std::numeric_limits<std::size_t>::max())
+        : grpc_context(grpc_context), duplex(grpc_context, reader_writer, client_context, high_water_mark)
+    {
+    }
+
+    MultiplexedClient(const MultiplexedClient&) = delete;
+    MultiplexedClient(MultiplexedClient&&) = delete;
+    MultiplexedClient& operator=(const MultiplexedClient&) = delete;
+    MultiplexedClient& operator=(MultiplexedClient&&) = delete;
+
+    ~MultiplexedClient() noexcept { this->complete_pending_calls(detail::InvokeHandler::NO); }
+
+    void start()
+    {
+        this->duplex.start_reading(
+            [this](grpc::ByteBuffer& buffer)
+            {
+                this->on_response(buffer);
+            },
+            [this]
+            {
+                this->is_read_done = true;
+                this->complete_pending_calls(detail::InvokeHandler::YES);
+            });
+    }
+
+    // Sends the request and completes with true once the matching response has been deserialized into response.
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto request(const Request& request, Response& response, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [&](auto completion_handler)
+            {
+                const auto [executor, allocator] = detail::get_associated_executor_and_allocator(completion_handler);
+                auto operation = detail::allocate_operation<false, void(bool)>(
+                    this->grpc_context, std::move(completion_handler), allocator);
+                this->grpc_context.work_started();
+                auto* call_operation = operation.get();
+                operation.release();
+                const auto id = this->next_id++;
+                grpc::ByteBuffer buffer;
+                if (this->is_read_done || !detail::frame_message(id, request, buffer))
+                {
+                    detail::WorkFinishedOnExit on_exit{this->grpc_context};
+                    call_operation->complete(detail::InvokeHandler::YES, false, this->grpc_context.get_allocator());
+                    return;
+                }
+                this->pending_calls.emplace(id, detail::MultiplexedCall<Response>{call_operation, &response});
+                this->duplex.write(std::move(buffer), asio::bind_executor(this->grpc_context,
+                                                                          [this, id](bool ok)
+                                                                          {
+                                                                              if (!ok)
+                                                                              {
+                                                                                  this->on_write_failed(id);
+                                                                              }
+                                                                          }));
+            },
+            token);
+    }
+
+    // Sends WritesDone after all requests have been written and completes once the stream has finished.
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto finish(grpc::Status& status, CompletionToken token = {})
+    {
+        return this->duplex.finish(status, std::move(token));
+    }
+
+    [[nodiscard]] std::size_t pending() const noexcept { return this->pending_calls.size(); }
+
+  private:
+    void on_response(grpc::ByteBuffer& buffer)
+    {
+        std::uint64_t id;
+        std::vector<grpc::Slice> payload;
+        if (!detail::read_correlation_id(buffer, id, payload))
+        {
+            return;
+        }
+        const auto it = this->pending_calls.find(id);
+        if (it == this->pending_calls.end())
+        {
+            return;
+        }
+        const auto call = it->second;
+        this->pending_calls.erase(it);
+        const auto ok = detail::deserialize_payload(payload, *call.response);
+        detail::WorkFinishedOnExit on_exit{this->grpc_context};
+        call.operation->complete(detail::InvokeHandler::YES, ok, this->grpc_context.get_allocator());
+    }
+
+    // The stream is broken, the call fails right away and the others once the read loop has ended
+    void on_write_failed(std::uint64_t id)
+    {
+        this->duplex.cancel();
+        const auto it = this->pending_calls.find(id);
+        if (it == this->pending_calls.end())
+        {
+            return;
+        }
+        const auto call = it->second;
+        this->pending_calls.erase(it);
+        detail::WorkFinishedOnExit on_exit{this->grpc_context};
+        call.operation->complete(detail::InvokeHandler::YES, false, this->grpc_context.get_allocator());
+    }
+
+    void complete_pending_calls(detail::InvokeHandler invoke_handler)
+    {
+        auto calls = std::move(this->pending_calls);
+        this->pending_calls.clear();
+        for (const auto& [id, call] : calls)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            call.operation->complete(invoke_handler, false, this->grpc_context.get_allocator());
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    agrpc::Duplex<grpc::GenericClientAsyncReaderWriter> duplex;
+    std::unordered_map<std::uint64_t, detail::MultiplexedCall<Response>> pending_calls;
+    std::uint64_t next_id{};
+    bool is_read_done{false};
+};
+
+// Server side of MultiplexedClient. Invokes handler(Request&, Responder) for every request, where invoking the
+// Responder with a Response sends it back under the request's correlation id. Responses must be sent before finish()
+// completes. Must only be used from the thread that runs the GrpcContext.
+template <class Request, class Response>
+class MultiplexedServer
+{
+  public:
+    class Responder
+    {
+      public:
+        void operator()(const Response& response) const { this->server->respond(this->id, response); }
+
+      private:
+        friend MultiplexedServer;
+
+        Responder(MultiplexedServer& server, std::uint64_t id) noexcept : server(&server), id(id) {}
+
+        MultiplexedServer* server;
+        std::uint64_t id;
+    };
+
+    MultiplexedServer(agrpc::GrpcContext& grpc_context, grpc::GenericServerAsyncReaderWriter& reader_writer,
+                      grpc::ServerContext& server_context,
+                      std::size_t high_water_mark = std::numeric_limits<std::size_t>::max())
+        : grpc_context(grpc_context), duplex(grpc_context, reader_writer, server_context, high_water_mark)
+    {
+    }
+
+    MultiplexedServer(const MultiplexedServer&) = delete;
+    MultiplexedServer(MultiplexedServer&&) = delete;
+    MultiplexedServer& operator=(const MultiplexedServer&) = delete;
+    MultiplexedServer& operator=(MultiplexedServer&&) = delete;
+
+    template <class Handler>
+    void start(Handler handler)
+    {
+        this->duplex.start_reading(
+            [this, handler = std::move(handler)](grpc::ByteBuffer& buffer) mutable
+            {
+                std::uint64_t id;
+                std::vector<grpc::Slice> payload;
+                Request request;
+                if (detail::read_correlation_id(buffer, id, payload) && detail::deserialize_payload(payload, request))
+                {
+                    handler(request, Responder{*this, id});
+                }
+            });
+    }
+
+    // Completes once the client is done writing, all responses have been written and the stream has finished.
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto finish(const grpc::Status& status, CompletionToken token = {})
+    {
+        return this->duplex.finish_after_reads(status, std::move(token));
+    }
+
+  private:
+    void respond(std::uint64_t id, const Response& response)
+    {
+        grpc::ByteBuffer buffer;
+        if (!detail::frame_message(id, response, buffer))
+        {
+            return;
+        }
+        // The client cannot receive any further response, end its pending calls by cancelling the stream
+        this->duplex.write(std::move(buffer), asio::bind_executor(this->grpc_context,
+                                                                  [this](bool ok)
+                                                                  {
+                                                                      if (!ok)
+                                                                      {
+                                                                          this->duplex.cancel();
+                                                                      }
+                                                                  }));
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    agrpc::Duplex<grpc::GenericServerAsyncReaderWriter> duplex;
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_MULTIPLEXER_HPP
@@ -0,0 +1,82 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_PROXY_HPP
+#define AGRPC_AGRPC_PROXY_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/memory.hpp"
+#include "agrpc/detail/proxy.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <grpcpp/generic/async_generic_service.h>
+
+#include <utility>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Forwards calls received through a grpc::AsyncGenericService to the grpc::GenericStub returned by the BackendPicker
+// without deserializing messages. Metadata, deadline, cancellation and status are propagated in both directions.
+template <class BackendPicker>
+class Proxy
+{
+  public:
+    Proxy(agrpc::GrpcContext& grpc_context, grpc::AsyncGenericService& service, BackendPicker backend_picker)
+        : grpc_context(grpc_context), service(service), backend_picker(std::move(backend_picker))
+    {
+    }
+
+    void start()
+    {
+        asio::post(this->grpc_context,
+                   [this]
+                   {
+                       this->request_next();
+                   });
+    }
+
+    // Stops accepting calls. The call that arrives next is finished with grpc::StatusCode::UNAVAILABLE and no further
+    // calls are requested from the service. Calls in progress run to completion.
+    void stop()
+    {
+        asio::post(this->grpc_context,
+                   [this]
+                   {
+                       this->is_stopped = true;
+                   });
+    }
+
+  private:
+    friend detail::ProxyRequestHandler<Proxy>;
+
+    void request_next()
+    {
+        auto call = detail::allocate<detail::ProxyCall>(this->grpc_context.get_allocator(), this->grpc_context);
+        auto& proxy_call = *call;
+        agrpc::request(this->service, proxy_call.server_context, proxy_call.server_reader_writer,
+                       asio::bind_executor(this->grpc_context,
+                                           detail::ProxyRequestHandler<Proxy>{*this, std::move(call)}));
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    grpc::AsyncGenericService& service;
+    BackendPicker backend_picker;
+    bool is_stopped{false};
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_PROXY_HPP
@@ -0,0 +1,181 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_RESPONSECACHE_HPP
+#define AGRPC_AGRPC_RESPONSECACHE_HPP
+
+#include "agrpc/detail/serialization.hpp"
+
+#include <grpcpp/support/byte_buffer.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace agrpc
+{
+// Cache of serialized unary responses keyed by method and serialized request. Responses are stored as ref-counted
+// grpc::ByteBuffer, finishing a grpc::ServerAsyncResponseWriter<grpc::ByteBuffer> (e.g. of a raw method) with a cached
+// buffer therefore neither serializes nor copies the payload. Entries are evicted in least-recently-used order once
+// the memory budget is exceeded and are considered absent after their time-to-live. Not thread-safe.
+class ResponseCache
+{
+  public:
+    using Key = std::string;
+    using Clock = std::chrono::steady_clock;
+
+    explicit ResponseCache(std::size_t memory_budget, Clock::duration time_to_live = Clock::duration::max())
+        : memory_budget(memory_budget), time_to_live(time_to_live)
+    {
+    }
+
+    // Returns std::nullopt if the request cannot be serialized, such requests must bypass the cache
+    template <class Request>
+    [[nodiscard]] static std::optional<Key> make_key(std::string_view method, const Request& request)
+    {
+        Key key{method};
+        key.push_back('\0');
+        if constexpr (std::is_same_v<grpc::ByteBuffer, Request>)
+        {
+            if (!detail::append_bytes(request, key))
+            {
+                return std::nullopt;
+            }
+        }
+        else
+        {
+            grpc::ByteBuffer buffer;
+            if (!detail::serialize(request, buffer) || !detail::append_bytes(buffer, key))
+            {
+                return std::nullopt;
+            }
+        }
+        return key;
+    }
+
+    // The returned pointer is valid until the next non-const member function call
+    [[nodiscard]] const grpc::ByteBuffer* find(const Key& key)
+    {
+        const auto it = this->entries.find(key);
+        if (it == this->entries.end())
+        {
+            return nullptr;
+        }
+        const auto entry = it->second;
+        if (entry->expiry <= Clock::now())
+        {
+            this->erase(entry);
+            return nullptr;
+        }
+        this->lru.splice(this->lru.begin(), this->lru, entry);
+        return &entry->response;
+    }
+
+    // Serializes the response once and caches the result. Returns a buffer that shares its slices with the cache entry
+    // or an invalid buffer if serialization failed.
+    template <class Response>
+    grpc::ByteBuffer insert(Key key, const Response& response)
+    {
+        grpc::ByteBuffer buffer;
+        if (!detail::serialize(response, buffer))
+        {
+            return {};
+        }
+        const auto size = ResponseCache::entry_size(key, buffer);
+        if (size > this->memory_budget)
+        {
+            return buffer;
+        }
+        if (const auto it = this->entries.find(key); it != this->entries.end())
+        {
+            this->erase(it->second);
+        }
+        this->lru.push_front(Entry{std::move(key), buffer, this->expiry_from_now(), size});
+        this->entries.emplace(std::string_view{this->lru.front().key}, this->lru.begin());
+        this->memory_usage += size;
+        while (this->memory_usage > this->memory_budget)
+        {
+            this->erase(std::prev(this->lru.end()));
+        }
+        return buffer;
+    }
+
+    void erase(const Key& key)
+    {
+        if (const auto it = this->entries.find(key); it != this->entries.end())
+        {
+            this->erase(it->second);
+        }
+    }
+
+    void clear() noexcept
+    {
+        this->entries.clear();
+        this->lru.clear();
+        this->memory_usage = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->lru.size(); }
+
+    [[nodiscard]] std::size_t used_memory() const noexcept { return this->memory_usage; }
+
+  private:
+    struct Entry
+    {
+        Key key;
+        grpc::ByteBuffer response;
+        Clock::time_point expiry;
+        std::size_t size;
+    };
+
+    using LRUList = std::list<Entry>;
+
+    static std::size_t entry_size(const Key& key, const grpc::ByteBuffer& buffer) noexcept
+    {
+        return sizeof(Entry) + key.size() + buffer.Length();
+    }
+
+    Clock::time_point expiry_from_now() const noexcept
+    {
+        const auto now = Clock::now();
+        if (this->time_to_live >= Clock::time_point::max() - now)
+        {
+            return Clock::time_point::max();
+        }
+        return now + this->time_to_live;
+    }
+
+    void erase(LRUList::iterator entry)
+    {
+        this->memory_usage -= entry->size;
+        this->entries.erase(std::string_view{entry->key});
+        this->lru.erase(entry);
+    }
+
+    std::size_t memory_budget;
+    Clock::duration time_to_live;
+    std::size_t memory_usage{};
+    LRUList lru;
+    std::unordered_map<std::string_view, LRUList::iterator> entries;
+};
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_RESPONSECACHE_HPP
@@ -0,0 +1,117 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_RETRY_HPP
+#define AGRPC_AGRPC_RETRY_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/initiate.hpp"
+#include "agrpc/detail/memory.hpp"
+#include "agrpc/detail/retry.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+
+#include <grpcpp/support/status.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+struct RetryPolicy
+{
+    using Duration = std::chrono::steady_clock::duration;
+
+    std::size_t max_attempts{3};
+    Duration initial_backoff{std::chrono::milliseconds(100)};
+    Duration max_backoff{std::chrono::seconds(1)};
+    double backoff_multiplier{2.0};
+    std::vector<grpc::StatusCode> retryable_status_codes{grpc::StatusCode::UNAVAILABLE};
+
+    [[nodiscard]] bool is_retryable(grpc::StatusCode code) const
+    {
+        return std::find(this->retryable_status_codes.begin(), this->retryable_status_codes.end(), code) !=
+               this->retryable_status_codes.end();
+    }
+};
+
+// Token bucket shared by all retries on one GrpcContext, obtained through asio::use_service<agrpc::RetryBudget>. Every
+// retryable failure removes a token, every success adds token_ratio tokens and retries are only permitted while more
+// than half of max_tokens are available. Must only be used from the thread that runs the GrpcContext.
+class RetryBudget : public asio::execution_context::service
+{
+  public:
+    using key_type = RetryBudget;
+
+    inline static asio::execution_context::id id{};
+
+    explicit RetryBudget(asio::execution_context& context) : asio::execution_context::service(context) {}
+
+    void configure(double new_max_tokens, double new_token_ratio) noexcept
+    {
+        this->max_tokens = new_max_tokens;
+        this->token_ratio = new_token_ratio;
+        this->tokens = new_max_tokens;
+    }
+
+    void on_success() noexcept { this->tokens = std::min(this->max_tokens, this->tokens + this->token_ratio); }
+
+    void on_failure() noexcept { this->tokens = std::max(0.0, this->tokens - 1.0); }
+
+    [[nodiscard]] bool is_retry_allowed() const noexcept { return this->tokens > this->max_tokens / 2.0; }
+
+    [[nodiscard]] double available_tokens() const noexcept { return this->tokens; }
+
+  private:
+    void shutdown() override {}
+
+    double max_tokens{10.0};
+    double token_ratio{0.1};
+    double tokens{10.0};
+};
+
+// Starts a unary call through start_call(grpc::ClientContext&, grpc::CompletionQueue*, std::size_t attempt) and
+// restarts it with a fresh ClientContext after an exponential backoff with full jitter while the status is retryable,
+// the policy's max_attempts has not been reached and the GrpcContext's RetryBudget permits it. Must be initiated from
+// the thread that runs the GrpcContext.
+template <class Response, class StartCall, class CompletionToken = agrpc::DefaultCompletionToken>
+auto retry(agrpc::RetryPolicy policy, StartCall start_call, Response& response, grpc::Status& status,
+           CompletionToken token = {})
+{
+    return asio::async_initiate<CompletionToken, void(bool)>(
+        [&](auto completion_handler, agrpc::RetryPolicy policy, StartCall start_call)
+        {
+            const auto [executor, allocator] = detail::get_associated_executor_and_allocator(completion_handler);
+            auto& grpc_context = detail::query_grpc_context(executor);
+            auto operation =
+                detail::allocate_operation<false, void(bool)>(grpc_context, std::move(completion_handler), allocator);
+            grpc_context.work_started();
+            using Call = detail::RetryCall<Response, StartCall, agrpc::RetryPolicy, agrpc::RetryBudget>;
+            auto call = detail::allocate<Call>(grpc_context.get_allocator(), grpc_context,
+                                               asio::use_service<agrpc::RetryBudget>(grpc_context), std::move(policy),
+                                               std::move(start_call), response, status, operation.get());
+            operation.release();
+            Call::start_attempt(std::move(call));
+        },
+        token, std::move(policy), std::move(start_call));
+}
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_RETRY_HPP
@@ -21,9 +21,23 @@
 #include "agrpc/initiate.hpp"
 
 #include <grpcpp/alarm.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
+
+#include <chrono>
+#include <memory>
 
 namespace agrpc
 {
+// Creates a grpc::ClientContext for a call made on behalf of the server's RPC. It inherits the RPC's deadline minus the
+// safety margin, leaving time to report the downstream result, and by default also its cancellation.
+inline std::unique_ptr<grpc::ClientContext> create_child_context(const grpc::ServerContext& server_context,
+                                                                 std::chrono::system_clock::duration safety_margin = {},
+                                                                 grpc::PropagationOptions options = {})
+{
+    return detail::create_child_context(server_context, safety_margin, options);
+}
+
 #if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
 template <class RPCContextImplementationAllocator>
 class RPCRequestContext
@@ -37,6 +51,25 @@ class RPCRequestContext
 
     constexpr auto args() const noexcept { return impl->args(); }
 
+    // Only available for RPCs requested with agrpc::with_notify_when_done. Returns true once the RPC has been
+    // cancelled, e.g. because the client went away or the deadline expired.
+    [[nodiscard]] bool is_cancelled() const { return impl->is_cancelled(); }
+
+    // Only available for RPCs requested with agrpc::with_notify_when_done. Like agrpc::create_child_context but the
+    // returned context is cancelled if this RPC gets cancelled while the context is still alive.
+    std::shared_ptr<grpc::ClientContext> create_child_context(std::chrono::system_clock::duration safety_margin = {},
+                                                              grpc::PropagationOptions options = {}) const
+    {
+        return impl->create_child_context(safety_margin, options);
+    }
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+    // Only available for RPCs requested with agrpc::with_notify_when_done. Emitted with
+    // cancellation_type::terminal when the RPC has been cancelled, e.g. because the client went away or the deadline
+    // expired. It is not emitted for RPCs that finish normally.
+    [[nodiscard]] asio::cancellation_slot cancellation_slot() const noexcept { return impl->cancellation_slot(); }
+#endif
+
   private:
     friend detail::RPCContextImplementation;
 
@@ -48,6 +81,13 @@ class RPCRequestContext
     }
 };
 
+// Passed to repeatedly_request to register grpc::ServerContext::AsyncNotifyWhenDone for every requested RPC
+struct WithNotifyWhenDone
+{
+};
+
+inline constexpr agrpc::WithNotifyWhenDone with_notify_when_done{};
+
 template <class Deadline, class CompletionToken = agrpc::DefaultCompletionToken>
 auto wait(grpc::Alarm& alarm, const Deadline& deadline, CompletionToken token = {})
 {
@@ -94,16 +134,56 @@ auto request(detail::ServerSingleArgRequest<RPC, Responder> rpc, Service& servic
         std::move(token));
 }
 
+template <class CompletionToken = agrpc::DefaultCompletionToken>
+auto request(grpc::AsyncGenericService& service, grpc::GenericServerContext& server_context,
+             grpc::GenericServerAsyncReaderWriter& reader_writer, CompletionToken token = {})
+{
+    return agrpc::grpc_initiate(
+        [&](agrpc::GrpcContext& grpc_context, void* tag)
+        {
+            auto* cq = grpc_context.get_server_completion_queue();
+            service.RequestCall(&server_context, &reader_writer, cq, cq, tag);
+        },
+        std::move(token));
+}
+
+// Completes when the RPC is done, after which server_context.IsCancelled() may be called. Must be initiated before the
+// RPC is requested. gRPC does not complete it for RPCs that never start, prefer agrpc::with_notify_when_done then.
+template <class CompletionToken = agrpc::DefaultCompletionToken>
+auto notify_when_done(grpc::ServerContext& server_context, CompletionToken token = {})
+{
+    return agrpc::grpc_initiate(
+        [&](const agrpc::GrpcContext&, void* tag)
+        {
+            server_context.AsyncNotifyWhenDone(tag);
+        },
+        std::move(token));
+}
+
 template <class RPC, class Service, class Request, class Responder, class Handler>
 void repeatedly_request(detail::ServerMultiArgRequest<RPC, Request, Responder> rpc, Service& service, Handler handler)
 {
-    detail::repeatedly_request(rpc, service, std::move(handler));
+    detail::repeatedly_request<detail::RPCContextBase>(rpc, service, std::move(handler));
 }
 
 template <class RPC, class Service, class Responder, class Handler>
 void repeatedly_request(detail::ServerSingleArgRequest<RPC, Responder> rpc, Service& service, Handler handler)
 {
-    detail::repeatedly_request(rpc, service, std::move(handler));
+    detail::repeatedly_request<detail::RPCContextBase>(rpc, service, std::move(handler));
+}
+
+template <class RPC, class Service, class Request, class Responder, class Handler>
+void repeatedly_request(detail::ServerMultiArgRequest<RPC, Request, Responder> rpc, Service& service, Handler handler,
+                        agrpc::WithNotifyWhenDone)
+{
+    detail::repeatedly_request<detail::NotifyWhenDoneRPCContextBase>(rpc, service, std::move(handler));
+}
+
+template <class RPC, class Service, class Responder, class Handler>
+void repeatedly_request(detail::ServerSingleArgRequest<RPC, Responder> rpc, Service& service, Handler handler,
+                        agrpc::WithNotifyWhenDone)
+{
+    detail::repeatedly_request<detail::NotifyWhenDoneRPCContextBase>(rpc, service, std::move(handler));
 }
 
 template <class Response, class Request, class CompletionToken = agrpc::DefaultCompletionToken>
@@ -139,6 +219,18 @@ auto write(grpc::ServerAsyncWriter<Response>& writer, const Response& response,
         std::move(token));
 }
 
+template <class Response, class CompletionToken = agrpc::DefaultCompletionToken>
+auto write(grpc::ServerAsyncWriter<Response>& writer, const Response& response, grpc::WriteOptions options,
+           CompletionToken token = {})
+{
+    return agrpc::grpc_initiate(
+        [&, options](const agrpc::GrpcContext&, void* tag)
+        {
+            writer.Write(response, options, tag);
+        },
+        std::move(token));
+}
+
 template <class Response, class Request, class CompletionToken = agrpc::DefaultCompletionToken>
 auto write(grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const Response& response,
            CompletionToken token = {})
@@ -151,6 +243,18 @@ auto write(grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, cons
         std::move(token));
 }
 
+template <class Response, class Request, class CompletionToken = agrpc::DefaultCompletionToken>
+auto write(grpc::ServerAsyncReaderWriter<Response, Request>& reader_writer, const Response& response,
+           grpc::WriteOptions options, CompletionToken token = {})
+{
+    return agrpc::grpc_initiate(
+        [&, options](const agrpc::GrpcContext&, void* tag)
+        {
+            reader_writer.Write(response, options, tag);
+        },
+        std::move(token));
+}
+
 template <class Response, class CompletionToken = agrpc::DefaultCompletionToken>
 auto finish(grpc::ServerAsyncWriter<Response>& writer, const grpc::Status& status, CompletionToken token = {})
 {
@@ -284,7 +388,8 @@ template <class RPC, class Stub, class Request, class Reader, class CompletionTo
 auto request(detail::ClientServerStreamingRequest<RPC, Request, Reader> rpc, Stub& stub,
              grpc::ClientContext& client_context, const Request& request, CompletionToken token = {})
 {
-    return detail::grpc_initiate_with_payload<Reader>(
+    return detail::grpc_initiate_with_payload_and_rpc_cancellation<Reader>(
+        client_context,
         [&, rpc](agrpc::GrpcContext& grpc_context, auto* tag)
         {
             tag->handler().payload = (stub.*rpc)(&client_context, request, grpc_context.get_completion_queue(), tag);
@@ -296,7 +401,8 @@ template <class RPC, class Stub, class Request, class Reader, class CompletionTo
 auto request(detail::ClientServerStreamingRequest<RPC, Request, Reader> rpc, Stub& stub,
              grpc::ClientContext& client_context, const Request& request, Reader& reader, CompletionToken token = {})
 {
-    return agrpc::grpc_initiate(
+    return detail::grpc_initiate_with_rpc_cancellation(
+        client_context,
         [&, rpc](agrpc::GrpcContext& grpc_context, void* tag) mutable
         {
             reader = (stub.*rpc)(&client_context, request, grpc_context.get_completion_queue(), tag);
@@ -308,7 +414,8 @@ template <class RPC, class Stub, class Writer, class Response, class CompletionT
 auto request(detail::ClientSideStreamingRequest<RPC, Writer, Response> rpc, Stub& stub,
              grpc::ClientContext& client_context, Response& response, CompletionToken token = {})
 {
-    return detail::grpc_initiate_with_payload<Writer>(
+    return detail::grpc_initiate_with_payload_and_rpc_cancellation<Writer>(
+        client_context,
         [&, rpc](agrpc::GrpcContext& grpc_context, auto* tag)
         {
             tag->handler().payload = (stub.*rpc)(&client_context, &response, grpc_context.get_completion_queue(), tag);
@@ -320,7 +427,8 @@ template <class RPC, class Stub, class Writer, class Response, class CompletionT
 auto request(detail::ClientSideStreamingRequest<RPC, Writer, Response> rpc, Stub& stub,
              grpc::ClientContext& client_context, Writer& writer, Response& response, CompletionToken token = {})
 {
-    return agrpc::grpc_initiate(
+    return detail::grpc_initiate_with_rpc_cancellation(
+        client_context,
         [&, rpc](agrpc::GrpcContext& grpc_context, void* tag) mutable
         {
             writer = (stub.*rpc)(&client_context, &response, grpc_context.get_completion_queue(), tag);
@@ -332,7 +440,8 @@ template <class RPC, class Stub, class ReaderWriter, class CompletionToken = agr
 auto request(detail::ClientBidirectionalStreamingRequest<RPC, ReaderWriter> rpc, Stub& stub,
              grpc::ClientContext& client_context, CompletionToken token = {})
 {
-    return detail::grpc_initiate_with_payload<ReaderWriter>(
+    return detail::grpc_initiate_with_payload_and_rpc_cancellation<ReaderWriter>(
+        client_context,
         [&, rpc](agrpc::GrpcContext& grpc_context, auto* tag)
         {
             tag->handler().payload = (stub.*rpc)(&client_context, grpc_context.get_completion_queue(), tag);
@@ -344,7 +453,8 @@ template <class RPC, class Stub, class ReaderWriter, class CompletionToken = agr
 auto request(detail::ClientBidirectionalStreamingRequest<RPC, ReaderWriter> rpc, Stub& stub,
              grpc::ClientContext& client_context, ReaderWriter& reader_writer, CompletionToken token = {})
 {
-    return agrpc::grpc_initiate(
+    return detail::grpc_initiate_with_rpc_cancellation(
+        client_context,
         [&, rpc](agrpc::GrpcContext& grpc_context, void* tag) mutable
         {
             reader_writer = (stub.*rpc)(&client_context, grpc_context.get_completion_queue(), tag);
@@ -352,6 +462,20 @@ auto request(detail::ClientBidirectionalStreamingRequest<RPC, ReaderWriter> rpc,
         std::move(token));
 }
 
+template <class CompletionToken = agrpc::DefaultCompletionToken>
+auto request(const std::string& method, grpc::GenericStub& stub, grpc::ClientContext& client_context,
+             std::unique_ptr<grpc::GenericClientAsyncReaderWriter>& reader_writer, CompletionToken token = {})
+{
+    return detail::grpc_initiate_with_rpc_cancellation(
+        client_context,
+        [&](agrpc::GrpcContext& grpc_context, void* tag)
+        {
+            reader_writer = stub.PrepareCall(&client_context, method, grpc_context.get_completion_queue());
+            reader_writer->StartCall(tag);
+        },
+        std::move(token));
+}
+
 template <class Response, class CompletionToken = agrpc::DefaultCompletionToken>
 auto read(grpc::ClientAsyncReader<Response>& reader, Response& response, CompletionToken token = {})
 {
@@ -386,6 +510,18 @@ auto write(grpc::ClientAsyncWriter<Request>& writer, const Request& request, Com
         std::move(token));
 }
 
+template <class Request, class CompletionToken = agrpc::DefaultCompletionToken>
+auto write(grpc::ClientAsyncWriter<Request>& writer, const Request& request, grpc::WriteOptions options,
+           CompletionToken token = {})
+{
+    return agrpc::grpc_initiate(
+        [&, options](const agrpc::GrpcContext&, void* tag)
+        {
+            writer.Write(request, options, tag);
+        },
+        std::move(token));
+}
+
 template <class Request, class CompletionToken = agrpc::DefaultCompletionToken>
 auto writes_done(grpc::ClientAsyncWriter<Request>& writer, CompletionToken token = {})
 {
@@ -409,6 +545,18 @@ auto write(grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, cons
         std::move(token));
 }
 
+template <class Request, class Response, class CompletionToken = agrpc::DefaultCompletionToken>
+auto write(grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, const Request& request,
+           grpc::WriteOptions options, CompletionToken token = {})
+{
+    return agrpc::grpc_initiate(
+        [&, options](const agrpc::GrpcContext&, void* tag)
+        {
+            reader_writer.Write(request, options, tag);
+        },
+        std::move(token));
+}
+
 template <class Request, class Response, class CompletionToken = agrpc::DefaultCompletionToken>
 auto writes_done(grpc::ClientAsyncReaderWriter<Request, Response>& reader_writer, CompletionToken token = {})
 {
@@ -476,46 +624,170 @@ auto read_initial_metadata(Responder& responder, CompletionToken token = {})
         },
         std::move(token));
 }
+
+/*
+Context-aware overloads
+
+Stream objects do not give access to their context. The following overloads take the grpc::ClientContext or
+grpc::ServerContext of the RPC as their first argument and invoke its TryCancel() when the cancellation slot
+associated with the completion handler is emitted. Cancellation applies to the entire RPC. The completion token must be
+passed explicitly.
+*/
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto read(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::read(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto write(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::write(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto writes_done(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::writes_done(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto finish(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::finish(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto read_initial_metadata(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::read_initial_metadata(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto write_and_finish(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::write_and_finish(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto finish_with_error(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::finish_with_error(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
+
+template <class Context, class Responder, class... Args, class = std::enable_if_t<detail::IS_RPC_CONTEXT_V<Context>>>
+auto send_initial_metadata(Context& context, Responder& responder, Args&&... args)
+{
+    return detail::initiate_with_rpc_cancellation_from_last(
+        context,
+        [&responder](auto&&... arguments)
+        {
+            return agrpc::send_initial_metadata(responder, std::forward<decltype(arguments)>(arguments)...);
+        },
+        std::forward<Args>(args)...);
+}
 #endif
 
-#ifdef AGRPC_UNIFEX
-inline constexpr struct AsyncRequestCPO
-{
-    template <class Executor, class RPC, class Service, class Request, class Responder>
-    auto operator()(Executor&& executor, detail::ServerMultiArgRequest<RPC, Request, Responder> rpc, Service& service,
-                    grpc::ServerContext& server_context, Request& request, Responder& responder) const
-        noexcept(unifex::is_nothrow_tag_invocable_v<AsyncRequestCPO, Executor,
-                                                    detail::ServerMultiArgRequest<RPC, Request, Responder>, Service&,
-                                                    grpc::ServerContext&, Request&, Responder&>)
-            -> unifex::tag_invoke_result_t<AsyncRequestCPO, Executor,
-                                           detail::ServerMultiArgRequest<RPC, Request, Responder>, Service&,
-                                           grpc::ServerContext&, Request&, Responder&>
+#if defined(AGRPC_UNIFEX) || defined(AGRPC_STDEXEC)
+namespace detail
+{
+template <class CPO>
+struct GrpcSenderCPO
+{
+    template <class Executor, class... Args>
+    constexpr auto operator()(Executor&& executor, Args&&... args) const
+        noexcept(noexcept(detail::exec::tag_invoke(std::declval<const CPO&>(), std::declval<Executor>(),
+                                                   std::declval<Args>()...)))
+            -> decltype(detail::exec::tag_invoke(std::declval<const CPO&>(), std::declval<Executor>(),
+                                                 std::declval<Args>()...))
     {
-        return unifex::tag_invoke(*this, std::forward<Executor>(executor), rpc, service, server_context, request,
-                                  responder);
+        return detail::exec::tag_invoke(static_cast<const CPO&>(*this), std::forward<Executor>(executor),
+                                        std::forward<Args>(args)...);
     }
+};
+}  // namespace detail
+
+inline constexpr struct AsyncWaitCPO : detail::GrpcSenderCPO<AsyncWaitCPO>
+{
+} async_wait{};
+
+inline constexpr struct AsyncRequestCPO : detail::GrpcSenderCPO<AsyncRequestCPO>
+{
 } async_request{};
 
-inline constexpr struct AsyncFinishCPO
+inline constexpr struct AsyncReadCPO : detail::GrpcSenderCPO<AsyncReadCPO>
 {
-    template <class Executor, class Response>
-    auto operator()(Executor&& executor, grpc::ServerAsyncResponseWriter<Response>& writer, const Response& response,
-                    const grpc::Status& status) const noexcept
-        -> unifex::tag_invoke_result_t<AsyncFinishCPO, Executor, grpc::ServerAsyncResponseWriter<Response>&,
-                                       const Response&, const grpc::Status&>
-    {
-        return unifex::tag_invoke(*this, std::forward<Executor>(executor), writer, response, status);
-    }
+} async_read{};
 
-    template <class Executor, class Response>
-    auto operator()(Executor&& executor, grpc::ClientAsyncResponseReader<Response>& reader, Response& response,
-                    grpc::Status& status) const noexcept
-        -> unifex::tag_invoke_result_t<AsyncFinishCPO, Executor, grpc::ClientAsyncResponseReader<Response>&, Response&,
-                                       grpc::Status&>
-    {
-        return unifex::tag_invoke(*this, std::forward<Executor>(executor), reader, response, status);
-    }
+inline constexpr struct AsyncWriteCPO : detail::GrpcSenderCPO<AsyncWriteCPO>
+{
+} async_write{};
+
+inline constexpr struct AsyncWritesDoneCPO : detail::GrpcSenderCPO<AsyncWritesDoneCPO>
+{
+} async_writes_done{};
+
+inline constexpr struct AsyncFinishCPO : detail::GrpcSenderCPO<AsyncFinishCPO>
+{
 } async_finish{};
+
+inline constexpr struct AsyncWriteAndFinishCPO : detail::GrpcSenderCPO<AsyncWriteAndFinishCPO>
+{
+} async_write_and_finish{};
+
+inline constexpr struct AsyncFinishWithErrorCPO : detail::GrpcSenderCPO<AsyncFinishWithErrorCPO>
+{
+} async_finish_with_error{};
+
+inline constexpr struct AsyncSendInitialMetadataCPO : detail::GrpcSenderCPO<AsyncSendInitialMetadataCPO>
+{
+} async_send_initial_metadata{};
+
+inline constexpr struct AsyncReadInitialMetadataCPO : detail::GrpcSenderCPO<AsyncReadInitialMetadataCPO>
+{
+} async_read_initial_metadata{};
 #endif
 }  // namespace agrpc
 
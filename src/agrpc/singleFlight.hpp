@@ -0,0 +1,107 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_SINGLEFLIGHT_HPP
+#define AGRPC_AGRPC_SINGLEFLIGHT_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/singleFlight.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Coalesces concurrent operations for the same key. Only the first caller's function is invoked, all callers complete
+// with the same shared result from a single local operation of the GrpcContext. The result is empty if the Resolver is
+// destroyed without being invoked. Must only be used from the thread that runs the GrpcContext. The Resolver refers to
+// the SingleFlight that created it and must be invoked or destroyed before that SingleFlight is destroyed.
+template <class Result, class Key = std::string, class Hash = std::hash<Key>>
+class SingleFlight
+{
+  public:
+    using key_type = Key;
+    using result_type = Result;
+    using Resolver = detail::SingleFlightResolver<SingleFlight>;
+
+    explicit SingleFlight(agrpc::GrpcContext& grpc_context) : grpc_context(grpc_context) {}
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight(SingleFlight&&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+    SingleFlight& operator=(SingleFlight&&) = delete;
+
+    ~SingleFlight() noexcept
+    {
+        for (auto& [key, waiters] : this->flights)
+        {
+            detail::SingleFlightWaiters<Result>{this->grpc_context, std::move(waiters), nullptr};
+        }
+    }
+
+    template <class Function, class CompletionToken = agrpc::DefaultCompletionToken>
+    auto run(Key key, Function function, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(std::shared_ptr<const Result>)>(
+            [this](auto completion_handler, Key key, Function function)
+            {
+                const auto allocator = asio::get_associated_allocator(completion_handler);
+                auto operation = detail::allocate_operation<true, void(std::shared_ptr<const Result>)>(
+                    this->grpc_context, std::move(completion_handler), allocator);
+                auto [it, is_first] = this->flights.try_emplace(std::move(key));
+                this->grpc_context.work_started();
+                it->second.push_back(operation.get());
+                operation.release();
+                if (is_first)
+                {
+                    std::move(function)(Resolver{*this, it->first});
+                }
+            },
+            token, std::move(key), std::move(function));
+    }
+
+    [[nodiscard]] bool is_in_flight(const Key& key) const { return this->flights.find(key) != this->flights.end(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->flights.size(); }
+
+  private:
+    friend Resolver;
+
+    void resolve(const Key& key, std::shared_ptr<const Result> result)
+    {
+        const auto it = this->flights.find(key);
+        if (it == this->flights.end())
+        {
+            return;
+        }
+        detail::SingleFlightWaiters<Result> waiters{this->grpc_context, std::move(it->second), std::move(result)};
+        this->flights.erase(it);
+        detail::create_no_arg_operation<true>(this->grpc_context, std::move(waiters), std::allocator<void>{});
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    std::unordered_map<Key, detail::SingleFlightWaiterQueue<Result>, Hash> flights;
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_SINGLEFLIGHT_HPP
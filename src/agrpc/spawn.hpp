@@ -0,0 +1,181 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_SPAWN_HPP
+#define AGRPC_AGRPC_SPAWN_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/spawn.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/grpcExecutor.hpp"
+
+#include <boost/coroutine/protected_stack_allocator.hpp>
+#include <boost/coroutine/stack_context.hpp>
+#include <boost/coroutine/stack_traits.hpp>
+#include <boost/coroutine/standard_stack_allocator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+namespace agrpc
+{
+// Coroutine stacks that are shared by all agrpc::spawn calls on one GrpcContext, obtained through
+// asio::use_service<agrpc::StackPool>. A finished coroutine returns its stack to the pool, stacks are only released to
+// the system when the GrpcContext is destroyed. This header requires linking with Boost.Coroutine and is therefore not
+// included by agrpc/asioGrpc.hpp.
+class StackPool : public asio::execution_context::service
+{
+  public:
+    using key_type = StackPool;
+
+    inline static asio::execution_context::id id{};
+
+    explicit StackPool(asio::execution_context& context) : asio::execution_context::service(context) {}
+
+    StackPool(const StackPool&) = delete;
+
+    StackPool& operator=(const StackPool&) = delete;
+
+    ~StackPool() override
+    {
+        for (auto& [key, stacks] : this->idle_stacks)
+        {
+            for (auto& stack : stacks)
+            {
+                StackPool::release(stack, key.second);
+            }
+        }
+    }
+
+    void allocate(boost::coroutines::stack_context& stack, std::size_t size, bool guard_page)
+    {
+        {
+            std::lock_guard lock{this->mutex};
+            auto it = this->idle_stacks.find({size, guard_page});
+            if (it != this->idle_stacks.end() && !it->second.empty())
+            {
+                stack = it->second.back();
+                it->second.pop_back();
+                return;
+            }
+        }
+        if (guard_page)
+        {
+            boost::coroutines::protected_stack_allocator{}.allocate(stack, size);
+        }
+        else
+        {
+            boost::coroutines::standard_stack_allocator{}.allocate(stack, size);
+        }
+    }
+
+    void deallocate(boost::coroutines::stack_context& stack, std::size_t size, bool guard_page)
+    {
+        std::lock_guard lock{this->mutex};
+        this->idle_stacks[{size, guard_page}].push_back(stack);
+    }
+
+    [[nodiscard]] std::size_t idle_stack_count() const
+    {
+        std::lock_guard lock{this->mutex};
+        std::size_t count{};
+        for (const auto& [key, stacks] : this->idle_stacks)
+        {
+            count += stacks.size();
+        }
+        return count;
+    }
+
+  private:
+    static void release(boost::coroutines::stack_context& stack, bool guard_page) noexcept
+    {
+        if (guard_page)
+        {
+            boost::coroutines::protected_stack_allocator{}.deallocate(stack);
+        }
+        else
+        {
+            boost::coroutines::standard_stack_allocator{}.deallocate(stack);
+        }
+    }
+
+    void shutdown() override {}
+
+    mutable std::mutex mutex;
+    std::map<std::pair<std::size_t, bool>, std::vector<boost::coroutines::stack_context>> idle_stacks;
+};
+
+// Boost.Coroutine StackAllocator that takes fixed-size stacks from the StackPool of a GrpcContext. With guard_page the
+// lowest page of every stack is protected so that an overflow faults instead of corrupting memory, at the cost of one
+// additional memory mapping per stack (see vm.max_map_count on Linux). The stack_size is raised to
+// boost::coroutines::stack_traits::minimum_size() if necessary.
+class PooledStackAllocator
+{
+  public:
+    static constexpr std::size_t DEFAULT_STACK_SIZE = 32 * 1024;
+
+    explicit PooledStackAllocator(agrpc::GrpcContext& grpc_context, std::size_t stack_size = DEFAULT_STACK_SIZE,
+                                  bool guard_page = true)
+        : pool(&asio::use_service<agrpc::StackPool>(grpc_context)),
+          stack_size(std::max(stack_size, boost::coroutines::stack_traits::minimum_size())),
+          guard_page(guard_page)
+    {
+    }
+
+    void allocate(boost::coroutines::stack_context& stack, std::size_t)
+    {
+        this->pool->allocate(stack, this->stack_size, this->guard_page);
+    }
+
+    void deallocate(boost::coroutines::stack_context& stack)
+    {
+        this->pool->deallocate(stack, this->stack_size, this->guard_page);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return this->stack_size; }
+
+  private:
+    agrpc::StackPool* pool;
+    std::size_t stack_size;
+    bool guard_page;
+};
+
+// Like asio::spawn(executor, function) but the stack of the coroutine is obtained from the PooledStackAllocator
+template <class Allocator, std::uint32_t Options, class Function>
+void spawn(const agrpc::BasicGrpcExecutor<Allocator, Options>& executor, Function&& function,
+           agrpc::PooledStackAllocator stack_allocator)
+{
+    const auto stack_size = stack_allocator.size();
+    detail::spawn_with_stack_allocator(
+        asio::bind_executor(asio::strand<agrpc::BasicGrpcExecutor<Allocator, Options>>(executor),
+                            &asio::detail::default_spawn_handler),
+        std::forward<Function>(function), std::move(stack_allocator), stack_size);
+}
+
+template <class Function>
+void spawn(agrpc::GrpcContext& grpc_context, Function&& function)
+{
+    agrpc::spawn(grpc_context.get_executor(), std::forward<Function>(function),
+                 agrpc::PooledStackAllocator{grpc_context});
+}
+}  // namespace agrpc
+#endif
+
+#endif  // AGRPC_AGRPC_SPAWN_HPP
@@ -0,0 +1,164 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_STREAMREADER_HPP
+#define AGRPC_AGRPC_STREAMREADER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextImplementation.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/streamReader.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Reads ahead into a ring of recycled messages so that the next Read is in flight while the previous message is being
+// processed. The message returned by next() stays valid until the following call to next(), a nullptr signals the
+// end of the stream. Must only be used from the thread that runs the GrpcContext.
+template <class Reader>
+class StreamReader
+{
+  public:
+    using message_type = detail::ReaderMessageT<Reader>;
+
+    explicit StreamReader(agrpc::GrpcContext& grpc_context, Reader& reader, std::size_t ring_size = 2)
+        : grpc_context(grpc_context), reader(reader), ring(ring_size < 2 ? 2 : ring_size)
+    {
+    }
+
+    StreamReader(const StreamReader&) = delete;
+    StreamReader(StreamReader&&) = delete;
+    StreamReader& operator=(const StreamReader&) = delete;
+    StreamReader& operator=(StreamReader&&) = delete;
+
+    // The Read in flight captures the StreamReader, it must not be destroyed before next() returned nullptr unless the
+    // GrpcContext has been stopped and will not run it anymore. To stop early, cancel the RPC and drain next().
+    ~StreamReader() noexcept
+    {
+        assert(this->grpc_context.is_stopped() || !this->is_reading);
+        if (this->waiter)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            this->waiter->complete(detail::InvokeHandler::NO, nullptr, this->grpc_context.get_allocator());
+        }
+    }
+
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto next(CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(message_type*)>(
+            [this](auto completion_handler)
+            {
+                this->has_current = false;
+                if (this->ready_count > 0 || this->is_finished)
+                {
+                    auto* message = this->pop_ready();
+                    const auto allocator = asio::get_associated_allocator(completion_handler);
+                    detail::create_no_arg_operation<true>(
+                        this->grpc_context,
+                        [completion_handler = std::move(completion_handler), message]() mutable
+                        {
+                            std::move(completion_handler)(message);
+                        },
+                        allocator);
+                }
+                else
+                {
+                    const auto allocator = asio::get_associated_allocator(completion_handler);
+                    auto operation = detail::allocate_operation<false, void(message_type*)>(
+                        this->grpc_context, std::move(completion_handler), allocator);
+                    this->grpc_context.work_started();
+                    this->waiter = operation.get();
+                    operation.release();
+                }
+                this->read_ahead();
+            },
+            token);
+    }
+
+  private:
+    message_type* pop_ready() noexcept
+    {
+        if (this->ready_count == 0)
+        {
+            return nullptr;
+        }
+        auto& message = this->ring[this->head];
+        this->head = (this->head + 1) % this->ring.size();
+        --this->ready_count;
+        this->has_current = true;
+        return &message;
+    }
+
+    void read_ahead()
+    {
+        const auto used_slots = this->ready_count + std::size_t{this->is_reading} + std::size_t{this->has_current};
+        if (this->is_reading || this->is_finished || used_slots == this->ring.size())
+        {
+            return;
+        }
+        this->is_reading = true;
+        auto& message = this->ring[(this->head + this->ready_count) % this->ring.size()];
+        agrpc::read(this->reader, message,
+                    asio::bind_executor(this->grpc_context,
+                                        [this](bool ok)
+                                        {
+                                            this->on_read(ok);
+                                        }));
+    }
+
+    void on_read(bool ok)
+    {
+        this->is_reading = false;
+        if (ok)
+        {
+            ++this->ready_count;
+        }
+        else
+        {
+            this->is_finished = true;
+        }
+        if (this->waiter)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            auto* message = this->pop_ready();
+            std::exchange(this->waiter, nullptr)
+                ->complete(detail::InvokeHandler::YES, message, this->grpc_context.get_allocator());
+        }
+        this->read_ahead();
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    Reader& reader;
+    std::vector<message_type> ring;
+    std::size_t head{};
+    std::size_t ready_count{};
+    detail::StreamReaderOperation<message_type>* waiter{};
+    bool has_current{false};
+    bool is_reading{false};
+    bool is_finished{false};
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_STREAMREADER_HPP
@@ -0,0 +1,210 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef AGRPC_AGRPC_STREAMWRITER_HPP
+#define AGRPC_AGRPC_STREAMWRITER_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/streamWriter.hpp"
+#include "agrpc/grpcContext.hpp"
+#include "agrpc/initiate.hpp"
+#include "agrpc/rpcs.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+namespace agrpc
+{
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_BOOST_ASIO)
+// Queues messages for a stream and keeps exactly one write in flight. Writes are buffered with
+// grpc::WriteOptions::set_buffer_hint while more messages are queued. write() may be called from any thread and
+// completes once the number of queued messages is at or below the high-water mark.
+template <class Writer>
+class StreamWriter
+{
+  public:
+    using message_type = detail::WriterMessageT<Writer>;
+
+    StreamWriter(agrpc::GrpcContext& grpc_context, Writer& writer, std::size_t high_water_mark)
+        : grpc_context(grpc_context), writer(writer), high_water_mark(high_water_mark)
+    {
+    }
+
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter(StreamWriter&&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+    StreamWriter& operator=(StreamWriter&&) = delete;
+
+    // The write in flight and the operations initiated by write() and flush() capture the StreamWriter, it must not be
+    // destroyed before they completed unless the GrpcContext has been stopped and will not run them anymore
+    ~StreamWriter() noexcept
+    {
+        assert(this->grpc_context.is_stopped() || this->queue.empty());
+        detail::complete_stream_writer_operations(this->grpc_context, this->blocked_writes, detail::InvokeHandler::NO,
+                                                  false);
+        detail::complete_stream_writer_operations(this->grpc_context, this->flushes, detail::InvokeHandler::NO,
+                                                  false);
+    }
+
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto write(message_type message, CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [this](auto completion_handler, message_type message)
+            {
+                const auto allocator = asio::get_associated_allocator(completion_handler);
+                detail::create_no_arg_operation<false>(
+                    this->grpc_context,
+                    [this, completion_handler = std::move(completion_handler), message = std::move(message)]() mutable
+                    {
+                        this->push(std::move(message), std::move(completion_handler));
+                    },
+                    allocator);
+            },
+            token, std::move(message));
+    }
+
+    // Completes once all queued messages have been written, after which the stream may be finished.
+    template <class CompletionToken = agrpc::DefaultCompletionToken>
+    auto flush(CompletionToken token = {})
+    {
+        return asio::async_initiate<CompletionToken, void(bool)>(
+            [this](auto completion_handler)
+            {
+                const auto allocator = asio::get_associated_allocator(completion_handler);
+                detail::create_no_arg_operation<false>(
+                    this->grpc_context,
+                    [this, completion_handler = std::move(completion_handler)]() mutable
+                    {
+                        if (this->queue.empty())
+                        {
+                            this->post_completion(std::move(completion_handler), !this->is_failed);
+                            return;
+                        }
+                        this->enqueue(this->flushes, std::move(completion_handler));
+                    },
+                    allocator);
+            },
+            token);
+    }
+
+  private:
+    template <class CompletionHandler>
+    void push(message_type&& message, CompletionHandler&& completion_handler)
+    {
+        if (this->is_failed)
+        {
+            this->post_completion(std::move(completion_handler), false);
+            return;
+        }
+        this->queue.push_back(std::move(message));
+        if (this->queue.size() == 1)
+        {
+            this->write_next();
+        }
+        if (this->queue.size() <= this->high_water_mark)
+        {
+            this->post_completion(std::move(completion_handler), true);
+        }
+        else
+        {
+            this->enqueue(this->blocked_writes, std::move(completion_handler));
+        }
+    }
+
+    template <class CompletionHandler>
+    void post_completion(CompletionHandler&& completion_handler, bool ok)
+    {
+        const auto allocator = asio::get_associated_allocator(completion_handler);
+        detail::create_no_arg_operation<true>(
+            this->grpc_context,
+            [completion_handler = std::move(completion_handler), ok]() mutable
+            {
+                std::move(completion_handler)(ok);
+            },
+            allocator);
+    }
+
+    template <class CompletionHandler>
+    void enqueue(detail::StreamWriterOperationQueue& operations, CompletionHandler&& completion_handler)
+    {
+        const auto allocator = asio::get_associated_allocator(completion_handler);
+        auto operation =
+            detail::allocate_operation<true, void(bool)>(this->grpc_context, std::move(completion_handler), allocator);
+        this->grpc_context.work_started();
+        operations.push_back(operation.get());
+        operation.release();
+    }
+
+    void write_next()
+    {
+        grpc::WriteOptions options;
+        if (this->queue.size() > 1)
+        {
+            options.set_buffer_hint();
+        }
+        agrpc::write(this->writer, this->queue.front(), options,
+                     asio::bind_executor(this->grpc_context,
+                                         [this](bool ok)
+                                         {
+                                             this->on_write(ok);
+                                         }));
+    }
+
+    void on_write(bool ok)
+    {
+        this->queue.pop_front();
+        if (!ok)
+        {
+            this->is_failed = true;
+            this->queue.clear();
+            detail::complete_stream_writer_operations(this->grpc_context, this->blocked_writes,
+                                                      detail::InvokeHandler::YES, false);
+            detail::complete_stream_writer_operations(this->grpc_context, this->flushes, detail::InvokeHandler::YES,
+                                                      false);
+            return;
+        }
+        if (!this->queue.empty())
+        {
+            this->write_next();
+        }
+        while (!this->blocked_writes.empty() && this->queue.size() <= this->high_water_mark)
+        {
+            detail::WorkFinishedOnExit on_exit{this->grpc_context};
+            auto* operation = this->blocked_writes.pop_front();
+            operation->complete(detail::InvokeHandler::YES, true, this->grpc_context.get_allocator());
+        }
+        if (this->queue.empty())
+        {
+            detail::complete_stream_writer_operations(this->grpc_context, this->flushes, detail::InvokeHandler::YES,
+                                                      true);
+        }
+    }
+
+    agrpc::GrpcContext& grpc_context;
+    Writer& writer;
+    std::size_t high_water_mark;
+    std::deque<message_type> queue;
+    detail::StreamWriterOperationQueue blocked_writes;
+    detail::StreamWriterOperationQueue flushes;
+    bool is_failed{false};
+};
+#endif
+}  // namespace agrpc
+
+#endif  // AGRPC_AGRPC_STREAMWRITER_HPP
@@ -0,0 +1,135 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_AGRPC_TASK_HPP
+#define AGRPC_AGRPC_TASK_HPP
+
+#include "agrpc/detail/asioForward.hpp"
+#include "agrpc/detail/grpcContextInteraction.hpp"
+#include "agrpc/detail/task.hpp"
+#include "agrpc/grpcContext.hpp"
+
+#include <memory>
+#include <utility>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+#include <coroutine>
+
+namespace agrpc
+{
+// Lazily started coroutine that runs on a GrpcContext. Frames that are created on the thread of a GrpcContext are
+// allocated from its local memory resource and must be destroyed on that thread, which includes destroying the
+// GrpcContext while Tasks are still suspended. Awaiting another Task resumes it through symmetric transfer.
+template <class T = void>
+class [[nodiscard]] Task
+{
+  public:
+    class promise_type : public detail::TaskPromise<T>
+    {
+      public:
+        Task get_return_object() noexcept { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->destroy();
+            this->handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() { this->destroy(); }
+
+    detail::TaskAwaiter<T, promise_type> operator co_await() && noexcept { return {this->handle}; }
+
+  private:
+    template <class Function>
+    friend void spawn_task(agrpc::GrpcContext& grpc_context, Function function);
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+    void destroy() noexcept
+    {
+        if (this->handle)
+        {
+            this->handle.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace detail
+{
+// Keeps the function alive for as long as the Task that it returns, just like asio::co_spawn does for lambdas with
+// captures
+template <class Function>
+agrpc::Task<> spawn_task_entry_point(Function function)
+{
+    co_await function();
+}
+}  // namespace detail
+
+// Completion token that turns RPC functions like agrpc::read into awaitables for agrpc::Task. The awaitable is used
+// as the completion queue tag so no allocation occurs.
+struct UseTask
+{
+};
+
+inline constexpr agrpc::UseTask use_task{};
+
+// Invokes the function on the GrpcContext's thread and runs the Task that it returns to completion. Like
+// asio::detached, exceptions that escape the Task are ignored.
+template <class Function>
+void spawn_task(agrpc::GrpcContext& grpc_context, Function function)
+{
+    detail::create_no_arg_operation<true>(
+        grpc_context,
+        [&grpc_context, function = std::move(function)]() mutable
+        {
+            auto task = detail::spawn_task_entry_point(std::move(function));
+            auto handle = std::exchange(task.handle, nullptr);
+            auto& promise = handle.promise();
+            promise.grpc_context = &grpc_context;
+            promise.root = handle;
+            handle.resume();
+        },
+        std::allocator<void>{});
+}
+}  // namespace agrpc
+
+#ifdef AGRPC_STANDALONE_ASIO
+namespace asio
+{
+template <class Signature>
+class async_result<::agrpc::UseTask, Signature> : public ::agrpc::detail::UseTaskAsyncResult
+{
+};
+}  // namespace asio
+#elif defined(AGRPC_BOOST_ASIO)
+namespace boost::asio
+{
+template <class Signature>
+class async_result<::agrpc::UseTask, Signature> : public ::agrpc::detail::UseTaskAsyncResult
+{
+};
+}  // namespace boost::asio
+#endif
+#endif
+
+#endif  // AGRPC_AGRPC_TASK_HPP
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "agrpc/asioGrpc.hpp"
+#include "agrpc/spawn.hpp"
 #include "protos/test.grpc.pb.h"
+#include "utils/allocationCounter.hpp"
 #include "utils/asioUtils.hpp"
 #include "utils/grpcClientServerTest.hpp"
 #include "utils/grpcContextTest.hpp"
@@ -21,8 +23,12 @@
 #include <doctest/doctest.h>
 #include <grpcpp/alarm.h>
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <vector>
 
 namespace test_asio_grpc_cpp20
 {
@@ -151,6 +157,63 @@ TEST_CASE_FIXTURE(test::GrpcClientServerTest, "awaitable server streaming")
     grpc_context.run();
 }
 
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "awaitable server streaming with use_awaitable_inline")
+{
+    static constexpr auto TOKEN = agrpc::use_awaitable_inline;
+    std::vector<std::int32_t> responses;
+    test::co_spawn(grpc_context,
+                   [&]() -> asio::awaitable<void>
+                   {
+                       test::v1::Request request;
+                       grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+                       CHECK(co_await agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming, service,
+                                                     server_context, request, writer, TOKEN));
+                       test::v1::Response response;
+                       for (std::int32_t i = 0; i < 3; ++i)
+                       {
+                           response.set_integer(request.integer() + i);
+                           CHECK(co_await agrpc::write(writer, response, TOKEN));
+                       }
+                       CHECK(co_await agrpc::finish(writer, grpc::Status::OK, TOKEN));
+                   });
+    test::co_spawn(grpc_context,
+                   [&]() -> asio::awaitable<void>
+                   {
+                       test::v1::Request request;
+                       request.set_integer(42);
+                       auto [reader, ok] = co_await agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub,
+                                                                   client_context, request, TOKEN);
+                       CHECK(ok);
+                       test::v1::Response response;
+                       while (co_await agrpc::read(*reader, response, TOKEN))
+                       {
+                           responses.push_back(response.integer());
+                       }
+                       grpc::Status status;
+                       CHECK(co_await agrpc::finish(*reader, status, TOKEN));
+                       CHECK(status.ok());
+                   });
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::int32_t>{42, 43, 44}), responses);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "use_awaitable_inline falls back to use_awaitable on a strand")
+{
+    auto strand = asio::make_strand(get_executor());
+    bool ok{false};
+    bool is_in_strand{false};
+    test::co_spawn(strand,
+                   [&]() -> asio::awaitable<void>
+                   {
+                       grpc::Alarm alarm;
+                       ok = co_await agrpc::wait(alarm, test::ten_milliseconds_from_now(), agrpc::use_awaitable_inline);
+                       is_in_strand = strand.running_in_this_thread();
+                   });
+    grpc_context.run();
+    CHECK(ok);
+    CHECK(is_in_strand);
+}
+
 TEST_CASE_FIXTURE(test::GrpcClientServerTest, "awaitable client streaming")
 {
     test::co_spawn(grpc_context,
@@ -295,6 +358,354 @@ TEST_CASE_FIXTURE(test::GrpcClientServerTest, "awaitable bidirectional streaming
         });
     grpc_context.run();
 }
+
+TEST_CASE("GrpcAwaitable coroutine per request does not allocate in steady state")
+{
+    static constexpr int CONCURRENCY = 4;
+    static constexpr int ROUNDS = 100;
+    std::size_t frame_cache_depth{};
+    SUBCASE("with frame cache") { frame_cache_depth = agrpc::detail::FrameCache::DEFAULT_DEPTH; }
+    SUBCASE("without frame cache") { frame_cache_depth = 0; }
+    agrpc::GrpcContext grpc_context{std::make_unique<grpc::CompletionQueue>(), frame_cache_depth};
+    int handled{};
+    std::optional<test::AllocationCounter> allocation_counter;
+    const auto handle_requests = [&](bool count_allocations)
+    {
+        asio::post(grpc_context,
+                   [&, count_allocations]
+                   {
+                       if (count_allocations)
+                       {
+                           allocation_counter.emplace();
+                       }
+                       for (int i = 0; i < CONCURRENCY; ++i)
+                       {
+                           asio::co_spawn(
+                               grpc_context,
+                               [&]() -> agrpc::GrpcAwaitable<void>
+                               {
+                                   co_await asio::post(grpc_context, agrpc::GRPC_USE_AWAITABLE);
+                                   ++handled;
+                               },
+                               asio::detached);
+                       }
+                   });
+        grpc_context.run();
+        grpc_context.reset();
+        const auto allocations = allocation_counter ? allocation_counter->count() : std::size_t{};
+        allocation_counter.reset();
+        return allocations;
+    };
+    handle_requests(false);
+    std::size_t allocations{};
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        allocations += handle_requests(true);
+    }
+    const auto duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    CHECK_EQ((ROUNDS + 1) * CONCURRENCY, handled);
+    MESSAGE("frame cache depth " << frame_cache_depth << ": " << allocations << " allocations and "
+                                 << duration.count() << "us for " << ROUNDS * CONCURRENCY << " coroutines");
+    if (frame_cache_depth == 0)
+    {
+        CHECK_LT(std::size_t{}, allocations);
+    }
+    else
+    {
+        CHECK_EQ(std::size_t{}, allocations);
+    }
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "yield_context Alarm wait on the strand of agrpc::spawn allocates at most once")
+{
+    static constexpr int STEPS = 100;
+    std::size_t allocations{};
+    int ok_count{};
+    const auto wait_repeatedly = [&](const auto& yield)
+    {
+        grpc::Alarm alarm;
+        ok_count += static_cast<int>(agrpc::wait(alarm, std::chrono::system_clock::now(), yield));
+        test::AllocationCounter allocation_counter;
+        for (int i = 0; i < STEPS; ++i)
+        {
+            ok_count += static_cast<int>(agrpc::wait(alarm, std::chrono::system_clock::now(), yield));
+        }
+        allocations = allocation_counter.count();
+    };
+    std::size_t max_allocations{};
+    SUBCASE("basic_yield_context of the strand")
+    {
+        agrpc::spawn(grpc_context,
+                     [&](auto yield)
+                     {
+                         wait_repeatedly(yield);
+                     });
+    }
+    SUBCASE("asio::yield_context")
+    {
+        // Dispatching to the strand through an any_io_executor re-allocates the type-erased strand
+        max_allocations = STEPS;
+        agrpc::spawn(grpc_context,
+                     [&](asio::yield_context yield)
+                     {
+                         wait_repeatedly(yield);
+                     });
+    }
+    grpc_context.run();
+    CHECK_EQ(STEPS + 1, ok_count);
+    MESSAGE(allocations << " allocations for " << STEPS << " steps");
+    CHECK_LE(allocations, max_allocations);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "Task server streaming with use_task")
+{
+    std::vector<std::int32_t> responses;
+    agrpc::spawn_task(grpc_context,
+                      [&]() -> agrpc::Task<>
+                      {
+                          test::v1::Request request;
+                          grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+                          CHECK(co_await agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming, service,
+                                                        server_context, request, writer, agrpc::use_task));
+                          test::v1::Response response;
+                          for (std::int32_t i = 0; i < 3; ++i)
+                          {
+                              response.set_integer(request.integer() + i);
+                              CHECK(co_await agrpc::write(writer, response, agrpc::use_task));
+                          }
+                          CHECK(co_await agrpc::finish(writer, grpc::Status::OK, agrpc::use_task));
+                      });
+    agrpc::spawn_task(grpc_context,
+                      [&]() -> agrpc::Task<>
+                      {
+                          test::v1::Request request;
+                          request.set_integer(42);
+                          auto [reader, ok] =
+                              co_await agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub,
+                                                      client_context, request, agrpc::use_task);
+                          CHECK(ok);
+                          const auto read_one = [&]() -> agrpc::Task<std::int32_t>
+                          {
+                              test::v1::Response response;
+                              if (!co_await agrpc::read(*reader, response, agrpc::use_task))
+                              {
+                                  co_return -1;
+                              }
+                              co_return response.integer();
+                          };
+                          for (auto value = co_await read_one(); value != -1; value = co_await read_one())
+                          {
+                              responses.push_back(value);
+                          }
+                          grpc::Status status;
+                          CHECK(co_await agrpc::finish(*reader, status, agrpc::use_task));
+                          CHECK(status.ok());
+                      });
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::int32_t>{42, 43, 44}), responses);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "Task compared to asio::awaitable for unary and streaming RPCs")
+{
+    static constexpr std::int32_t COUNT = 200;
+    std::int32_t unary_sum{};
+    std::int32_t read_count{};
+    const auto measure = [&](auto&& spawn)
+    {
+        unary_sum = 0;
+        read_count = 0;
+        const auto start = std::chrono::steady_clock::now();
+        spawn();
+        grpc_context.run();
+        grpc_context.reset();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    };
+    const auto spawn_task_unary = [&]
+    {
+        agrpc::spawn_task(grpc_context,
+                          [&]() -> agrpc::Task<>
+                          {
+                              for (std::int32_t i = 0; i < COUNT; ++i)
+                              {
+                                  grpc::ServerContext context;
+                                  test::v1::Request request;
+                                  grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&context};
+                                  co_await agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service,
+                                                          context, request, writer, agrpc::use_task);
+                                  test::v1::Response response;
+                                  response.set_integer(request.integer());
+                                  co_await agrpc::finish(writer, response, grpc::Status::OK, agrpc::use_task);
+                              }
+                          });
+        agrpc::spawn_task(grpc_context,
+                          [&]() -> agrpc::Task<>
+                          {
+                              for (std::int32_t i = 0; i < COUNT; ++i)
+                              {
+                                  grpc::ClientContext context;
+                                  test::v1::Request request;
+                                  request.set_integer(i);
+                                  const auto reader =
+                                      stub->AsyncUnary(&context, request, grpc_context.get_completion_queue());
+                                  test::v1::Response response;
+                                  grpc::Status status;
+                                  co_await agrpc::finish(*reader, response, status, agrpc::use_task);
+                                  unary_sum += response.integer();
+                              }
+                          });
+    };
+    const auto spawn_awaitable_unary = [&]
+    {
+        test::co_spawn(grpc_context,
+                       [&]() -> asio::awaitable<void>
+                       {
+                           for (std::int32_t i = 0; i < COUNT; ++i)
+                           {
+                               grpc::ServerContext context;
+                               test::v1::Request request;
+                               grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&context};
+                               co_await agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service,
+                                                       context, request, writer);
+                               test::v1::Response response;
+                               response.set_integer(request.integer());
+                               co_await agrpc::finish(writer, response, grpc::Status::OK);
+                           }
+                       });
+        test::co_spawn(grpc_context,
+                       [&]() -> asio::awaitable<void>
+                       {
+                           for (std::int32_t i = 0; i < COUNT; ++i)
+                           {
+                               grpc::ClientContext context;
+                               test::v1::Request request;
+                               request.set_integer(i);
+                               const auto reader =
+                                   stub->AsyncUnary(&context, request, grpc_context.get_completion_queue());
+                               test::v1::Response response;
+                               grpc::Status status;
+                               co_await agrpc::finish(*reader, response, status);
+                               unary_sum += response.integer();
+                           }
+                       });
+    };
+    // The first RPCs on the channel pay for connection setup, keep that out of the comparison
+    measure(spawn_awaitable_unary);
+    const auto task_unary = measure(spawn_task_unary);
+    CHECK_EQ(COUNT * (COUNT - 1) / 2, unary_sum);
+    const auto awaitable_unary = measure(spawn_awaitable_unary);
+    CHECK_EQ(COUNT * (COUNT - 1) / 2, unary_sum);
+    const auto task_streaming = measure(
+        [&]
+        {
+            agrpc::spawn_task(grpc_context,
+                              [&]() -> agrpc::Task<>
+                              {
+                                  test::v1::Request request;
+                                  grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+                                  co_await agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming,
+                                                          service, server_context, request, writer, agrpc::use_task);
+                                  test::v1::Response response;
+                                  for (std::int32_t i = 0; i < COUNT; ++i)
+                                  {
+                                      co_await agrpc::write(writer, response, agrpc::use_task);
+                                  }
+                                  co_await agrpc::finish(writer, grpc::Status::OK, agrpc::use_task);
+                              });
+            agrpc::spawn_task(grpc_context,
+                              [&]() -> agrpc::Task<>
+                              {
+                                  test::v1::Request request;
+                                  auto [reader, ok] =
+                                      co_await agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming,
+                                                              *stub, client_context, request, agrpc::use_task);
+                                  test::v1::Response response;
+                                  while (co_await agrpc::read(*reader, response, agrpc::use_task))
+                                  {
+                                      ++read_count;
+                                  }
+                                  grpc::Status status;
+                                  co_await agrpc::finish(*reader, status, agrpc::use_task);
+                              });
+        });
+    CHECK_EQ(COUNT, read_count);
+    grpc::ServerContext other_server_context;
+    grpc::ClientContext other_client_context;
+    const auto awaitable_streaming = measure(
+        [&]
+        {
+            test::co_spawn(grpc_context,
+                           [&]() -> asio::awaitable<void>
+                           {
+                               test::v1::Request request;
+                               grpc::ServerAsyncWriter<test::v1::Response> writer{&other_server_context};
+                               co_await agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming, service,
+                                                       other_server_context, request, writer);
+                               test::v1::Response response;
+                               for (std::int32_t i = 0; i < COUNT; ++i)
+                               {
+                                   co_await agrpc::write(writer, response);
+                               }
+                               co_await agrpc::finish(writer, grpc::Status::OK);
+                           });
+            test::co_spawn(grpc_context,
+                           [&]() -> asio::awaitable<void>
+                           {
+                               test::v1::Request request;
+                               auto [reader, ok] =
+                                   co_await agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub,
+                                                           other_client_context, request);
+                               test::v1::Response response;
+                               while (co_await agrpc::read(*reader, response))
+                               {
+                                   ++read_count;
+                               }
+                               grpc::Status status;
+                               co_await agrpc::finish(*reader, status);
+                           });
+        });
+    CHECK_EQ(COUNT, read_count);
+    MESSAGE("unary x" << COUNT << ": agrpc::Task " << task_unary.count() << "us, asio::awaitable "
+                      << awaitable_unary.count() << "us");
+    MESSAGE("server streaming x" << COUNT << ": agrpc::Task " << task_streaming.count() << "us, asio::awaitable "
+                                 << awaitable_streaming.count() << "us");
+}
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "awaitable_operators cancel client read through its context")
+{
+    test::co_spawn(grpc_context,
+                   [&]() -> asio::awaitable<void>
+                   {
+                       grpc::ServerAsyncReaderWriter<test::v1::Response, test::v1::Request> reader_writer{
+                           &server_context};
+                       CHECK(co_await agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming,
+                                                     service, server_context, reader_writer));
+                       test::v1::Request request;
+                       CHECK_FALSE(co_await agrpc::read(reader_writer, request));
+                   });
+    test::co_spawn(grpc_context,
+                   [&]() -> asio::awaitable<void>
+                   {
+                       using namespace asio::experimental::awaitable_operators;
+                       std::unique_ptr<grpc::ClientAsyncReaderWriter<test::v1::Request, test::v1::Response>>
+                           reader_writer;
+                       CHECK(co_await agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming, *stub,
+                                                     client_context, reader_writer));
+                       test::v1::Response response;
+                       grpc::Alarm alarm;
+                       const auto result =
+                           co_await (agrpc::read(client_context, *reader_writer, response, asio::use_awaitable) ||
+                                     agrpc::wait(alarm, test::ten_milliseconds_from_now(), asio::use_awaitable));
+                       CHECK_EQ(1, result.index());
+                       grpc::Status status;
+                       CHECK(co_await agrpc::finish(*reader_writer, status));
+                       CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+                   });
+    grpc_context.run();
+}
+#endif
 #endif
 
 TEST_SUITE_END();
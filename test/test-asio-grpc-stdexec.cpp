@@ -0,0 +1,92 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "agrpc/asioGrpc.hpp"
+#include "utils/asioForward.hpp"
+#include "utils/grpcContextTest.hpp"
+
+#include <doctest/doctest.h>
+#include <grpcpp/alarm.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <tuple>
+
+namespace test_asio_grpc
+{
+using namespace agrpc;
+
+TEST_SUITE_BEGIN(ASIO_GRPC_TEST_CPP_VERSION* doctest::timeout(180.0));
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "stdexec schedule onto a GrpcContext")
+{
+    bool invoked_on_grpc_context = false;
+    stdexec::sync_wait(stdexec::when_all(stdexec::then(stdexec::schedule(get_executor()),
+                                                       [&]
+                                                       {
+                                                           invoked_on_grpc_context =
+                                                               get_executor().running_in_this_thread();
+                                                       }),
+                                         stdexec::then(stdexec::just(),
+                                                       [&]
+                                                       {
+                                                           grpc_context.run();
+                                                       })));
+    CHECK(invoked_on_grpc_context);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "stdexec wait for Alarm")
+{
+    grpc::Alarm alarm;
+    auto result = stdexec::sync_wait(
+        stdexec::when_all(agrpc::async_wait(get_executor(), alarm, test::ten_milliseconds_from_now()),
+                          stdexec::then(stdexec::just(),
+                                        [&]
+                                        {
+                                            grpc_context.run();
+                                        })));
+    REQUIRE(result);
+    CHECK(std::get<0>(*result));
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "stdexec wait for Alarm on a stopped GrpcContext completes with stopped")
+{
+    grpc_context.stop();
+    grpc::Alarm alarm;
+    CHECK_FALSE(stdexec::sync_wait(agrpc::async_wait(get_executor(), alarm, test::ten_milliseconds_from_now())));
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "stdexec stop request cancels an Alarm wait")
+{
+    grpc::Alarm alarm;
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = std::chrono::system_clock::now() + std::chrono::hours(1);
+    CHECK_THROWS_AS(stdexec::sync_wait(stdexec::when_all(
+                        agrpc::async_wait(get_executor(), alarm, deadline),
+                        stdexec::then(stdexec::just(),
+                                      []
+                                      {
+                                          throw std::runtime_error{"stop"};
+                                      }),
+                        stdexec::then(stdexec::just(),
+                                      [&]
+                                      {
+                                          grpc_context.run();
+                                      }))),
+                    std::runtime_error);
+    CHECK_GT(std::chrono::minutes(1), std::chrono::steady_clock::now() - start);
+}
+
+TEST_SUITE_END();
+}  // namespace test_asio_grpc
@@ -21,9 +21,13 @@
 #include <doctest/doctest.h>
 #include <grpcpp/alarm.h>
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 namespace test_asio_grpc
 {
@@ -33,9 +37,6 @@ TEST_SUITE_BEGIN(ASIO_GRPC_TEST_CPP_VERSION* doctest::timeout(180.0));
 
 TEST_CASE_FIXTURE(test::GrpcClientServerTest, "unifex::task unary")
 {
-    grpc_context.work_started();
-    grpc_context.work_started();
-    grpc_context.work_started();
     bool server_finish_ok = false;
     bool client_finish_ok = false;
     unifex::sync_wait(unifex::when_all(
@@ -67,5 +68,92 @@ TEST_CASE_FIXTURE(test::GrpcClientServerTest, "unifex::task unary")
     CHECK(client_finish_ok);
 }
 
+TEST_CASE_FIXTURE(test::GrpcContextTest, "unifex::task wait for Alarm")
+{
+    bool ok = false;
+    unifex::sync_wait(unifex::when_all(
+        [&]() -> unifex::task<void>
+        {
+            grpc::Alarm alarm;
+            ok = co_await agrpc::async_wait(get_executor(), alarm, test::ten_milliseconds_from_now());
+        }(),
+        [&]() -> unifex::task<void>
+        {
+            grpc_context.run();
+            co_return;
+        }()));
+    CHECK(ok);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "unifex wait for Alarm on a stopped GrpcContext completes with done")
+{
+    grpc_context.stop();
+    grpc::Alarm alarm;
+    CHECK_FALSE(unifex::sync_wait(agrpc::async_wait(get_executor(), alarm, test::ten_milliseconds_from_now())));
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "unifex::task schedule and schedule_after onto a GrpcContext")
+{
+    bool scheduled = false;
+    bool scheduled_after = false;
+    unifex::sync_wait(unifex::when_all(
+        [&]() -> unifex::task<void>
+        {
+            co_await unifex::schedule(get_executor());
+            scheduled = true;
+            const auto start = std::chrono::steady_clock::now();
+            co_await unifex::schedule_after(get_executor(), std::chrono::milliseconds(10));
+            scheduled_after = std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5);
+        }(),
+        [&]() -> unifex::task<void>
+        {
+            grpc_context.run();
+            co_return;
+        }()));
+    CHECK(scheduled);
+    CHECK(scheduled_after);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "unifex::task server streaming")
+{
+    grpc::Status status;
+    std::vector<std::int32_t> responses;
+    unifex::sync_wait(unifex::when_all(
+        [&]() -> unifex::task<void>
+        {
+            test::v1::Request request;
+            grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+            CHECK(co_await agrpc::async_request(get_executor(), &test::v1::Test::AsyncService::RequestServerStreaming,
+                                                service, server_context, request, writer));
+            CHECK(co_await agrpc::async_send_initial_metadata(get_executor(), writer));
+            test::v1::Response response;
+            response.set_integer(request.integer());
+            CHECK(co_await agrpc::async_write_and_finish(get_executor(), writer, response, grpc::WriteOptions{},
+                                                        grpc::Status::OK));
+        }(),
+        [&]() -> unifex::task<void>
+        {
+            test::v1::Request request;
+            request.set_integer(42);
+            std::unique_ptr<grpc::ClientAsyncReader<test::v1::Response>> reader;
+            CHECK(co_await agrpc::async_request(get_executor(), &test::v1::Test::Stub::AsyncServerStreaming, *stub,
+                                                client_context, request, reader));
+            CHECK(co_await agrpc::async_read_initial_metadata(get_executor(), *reader));
+            test::v1::Response response;
+            while (co_await agrpc::async_read(get_executor(), *reader, response))
+            {
+                responses.push_back(response.integer());
+            }
+            CHECK(co_await agrpc::async_finish(get_executor(), *reader, status));
+        }(),
+        [&]() -> unifex::task<void>
+        {
+            grpc_context.run();
+            co_return;
+        }()));
+    CHECK(status.ok());
+    CHECK_EQ(std::vector<std::int32_t>{42}, responses);
+}
+
 TEST_SUITE_END();
 }  // namespace test_asio_grpc
\ No newline at end of file
@@ -13,18 +13,29 @@
 // limitations under the License.
 
 #include "agrpc/asioGrpc.hpp"
+#include "agrpc/spawn.hpp"
 #include "protos/test.grpc.pb.h"
 #include "utils/asioUtils.hpp"
+#include "utils/freePort.hpp"
 #include "utils/grpcClientServerTest.hpp"
 #include "utils/grpcContextTest.hpp"
 
 #include <doctest/doctest.h>
 #include <grpcpp/alarm.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <optional>
+#include <set>
+#include <stdexcept>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 namespace test_asio_grpc
 {
@@ -257,6 +268,122 @@ TEST_CASE_FIXTURE(test::GrpcContextTest, "asio::post a asio::steady_timer")
     CHECK_EQ(test::ErrorCode{}, error_code);
 }
 
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Alarm completions hop to the associated io_context in one batch")
+{
+    asio::io_context io_context;
+    std::array<grpc::Alarm, 3> alarms;
+    std::size_t completions{};
+    bool invoked_on_io_context = true;
+    asio::post(grpc_context,
+               [&]
+               {
+                   for (auto& alarm : alarms)
+                   {
+                       agrpc::wait(alarm, std::chrono::system_clock::now(),
+                                   asio::bind_executor(io_context,
+                                                       [&](bool ok)
+                                                       {
+                                                           invoked_on_io_context =
+                                                               invoked_on_io_context && ok &&
+                                                               io_context.get_executor().running_in_this_thread();
+                                                           ++completions;
+                                                       }));
+                   }
+                   // Lets all Alarms expire before the GrpcContext looks at its completion queue
+                   std::this_thread::sleep_for(std::chrono::milliseconds(50));
+               });
+    grpc_context.run();
+    CHECK_EQ(std::size_t{}, completions);
+    CHECK_EQ(std::size_t{1}, io_context.run());
+    CHECK_EQ(alarms.size(), completions);
+    CHECK(invoked_on_io_context);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Alarm completion is dispatched through the associated strand")
+{
+    auto strand = asio::make_strand(get_executor());
+    bool invoked_in_strand = false;
+    grpc::Alarm alarm;
+    asio::post(grpc_context,
+               [&]
+               {
+                   agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                               asio::bind_executor(strand,
+                                                   [&](bool ok)
+                                                   {
+                                                       invoked_in_strand = ok && strand.running_in_this_thread();
+                                                   }));
+               });
+    grpc_context.run();
+    CHECK(invoked_in_strand);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Alarm completion is dispatched through a strand in an any_io_executor")
+{
+    auto strand = asio::make_strand(get_executor());
+    bool invoked_in_strand = false;
+    grpc::Alarm alarm;
+    asio::post(grpc_context,
+               [&]
+               {
+                   agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                               asio::bind_executor(asio::any_io_executor{strand},
+                                                   [&](bool ok)
+                                                   {
+                                                       invoked_in_strand = ok && strand.running_in_this_thread();
+                                                   }));
+               });
+    grpc_context.run();
+    CHECK(invoked_in_strand);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Alarm wait initiated from a completion on the io_context")
+{
+    asio::io_context io_context;
+    std::optional guard{asio::make_work_guard(grpc_context)};
+    std::optional io_context_guard{asio::make_work_guard(io_context)};
+    bool second_invoked_on_io_context = false;
+    grpc::Alarm alarm;
+    const auto second_wait = [&]
+    {
+        agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                    asio::bind_executor(io_context,
+                                        [&](bool ok)
+                                        {
+                                            second_invoked_on_io_context =
+                                                ok && io_context.get_executor().running_in_this_thread();
+                                            guard.reset();
+                                            io_context_guard.reset();
+                                        }));
+    };
+    asio::post(grpc_context,
+               [&]
+               {
+                   agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                               asio::bind_executor(io_context,
+                                                   [&](bool)
+                                                   {
+                                                       second_wait();
+                                                   }));
+               });
+    std::thread grpc_context_thread{[&]
+                                    {
+                                        grpc_context.run();
+                                    }};
+    io_context.run();
+    grpc_context_thread.join();
+    CHECK(second_invoked_on_io_context);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Alarm wait with an io_context handler outside of a GrpcContext throws")
+{
+    asio::io_context io_context;
+    grpc::Alarm alarm;
+    CHECK_THROWS_AS(agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                                asio::bind_executor(io_context, [](bool) {})),
+                    std::logic_error);
+}
+
 TEST_CASE_FIXTURE(test::GrpcContextTest, "asio::spawn with yield_context")
 {
     bool ok = false;
@@ -270,6 +397,38 @@ TEST_CASE_FIXTURE(test::GrpcContextTest, "asio::spawn with yield_context")
     CHECK(ok);
 }
 
+TEST_CASE_FIXTURE(test::GrpcContextTest, "agrpc::spawn reuses stacks from the StackPool")
+{
+    static constexpr std::size_t COROUTINE_COUNT = 3;
+    bool guard_page{};
+    SUBCASE("with guard page") { guard_page = true; }
+    SUBCASE("without guard page") { guard_page = false; }
+    std::size_t ok_count{};
+    const auto spawn_coroutines = [&]
+    {
+        for (std::size_t i = 0; i < COROUTINE_COUNT; ++i)
+        {
+            agrpc::spawn(
+                get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::Alarm alarm;
+                    ok_count += static_cast<std::size_t>(agrpc::wait(alarm, test::ten_milliseconds_from_now(), yield));
+                },
+                agrpc::PooledStackAllocator{grpc_context, 64 * 1024, guard_page});
+        }
+        grpc_context.run();
+        grpc_context.reset();
+    };
+    auto& stack_pool = asio::use_service<agrpc::StackPool>(grpc_context);
+    spawn_coroutines();
+    CHECK_EQ(COROUTINE_COUNT, ok_count);
+    CHECK_EQ(COROUTINE_COUNT, stack_pool.idle_stack_count());
+    spawn_coroutines();
+    CHECK_EQ(2 * COROUTINE_COUNT, ok_count);
+    CHECK_EQ(COROUTINE_COUNT, stack_pool.idle_stack_count());
+}
+
 TEST_CASE_FIXTURE(test::GrpcContextTest, "post from multiple threads")
 {
     static constexpr auto THREAD_COUNT = 32;
@@ -519,6 +678,73 @@ TEST_CASE_FIXTURE(test::GrpcClientServerTest, "yield_context server streaming")
     grpc_context.run();
 }
 
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "yield_context server streaming with context-aware overloads")
+{
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming, service, server_context,
+                                         request, writer, yield));
+                    CHECK(agrpc::send_initial_metadata(server_context, writer, yield));
+                    test::v1::Response response;
+                    response.set_integer(21);
+                    CHECK(agrpc::write(server_context, writer, response, yield));
+                    CHECK(agrpc::finish(server_context, writer, grpc::Status::OK, yield));
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    request.set_integer(42);
+                    auto [reader, ok] = agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub,
+                                                       client_context, request, yield);
+                    CHECK(ok);
+                    CHECK(agrpc::read_initial_metadata(client_context, *reader, yield));
+                    test::v1::Response response;
+                    CHECK(agrpc::read(client_context, *reader, response, yield));
+                    grpc::Status status;
+                    CHECK(agrpc::finish(client_context, *reader, status, yield));
+                    CHECK(status.ok());
+                    CHECK_EQ(21, response.integer());
+                });
+    grpc_context.run();
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "notify_when_done completes when the client cancels the RPC")
+{
+    bool is_cancelled{false};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+                    agrpc::notify_when_done(server_context, asio::bind_executor(get_executor(),
+                                                                                [&](bool)
+                                                                                {
+                                                                                    is_cancelled =
+                                                                                        server_context.IsCancelled();
+                                                                                }));
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request,
+                                         writer, yield));
+                    client_context.TryCancel();
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    auto reader =
+                        stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, response, status, yield));
+                    CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+                });
+    grpc_context.run();
+    CHECK(is_cancelled);
+}
+
 TEST_CASE_FIXTURE(test::GrpcClientServerTest, "yield_context client streaming")
 {
     bool use_client_convenience{};
@@ -773,87 +999,1691 @@ TEST_CASE_FIXTURE(GrpcRepeatedlyRequestTest, "yield_context repeatedly_request c
     CHECK_EQ(4, request_count);
 }
 
-TEST_CASE_FIXTURE(test::GrpcClientServerTest, "RPC step after grpc_context stop")
+TEST_CASE_FIXTURE(GrpcRepeatedlyRequestTest, "repeatedly_request with_notify_when_done observes client cancellation")
 {
-    std::optional<bool> ok;
+    bool is_cancelled{false};
+    agrpc::repeatedly_request(
+        &test::v1::Test::AsyncService::RequestUnary, service,
+        asio::bind_executor(get_executor(),
+                            [&](auto&& rpc_context, bool ok)
+                            {
+                                if (!ok)
+                                {
+                                    return;
+                                }
+                                asio::spawn(get_executor(),
+                                            [&, rpc_context = std::move(rpc_context)](asio::yield_context yield)
+                                            {
+                                                grpc::Alarm alarm;
+                                                while (!rpc_context.is_cancelled())
+                                                {
+                                                    agrpc::wait(alarm, test::ten_milliseconds_from_now(), yield);
+                                                }
+                                                is_cancelled = true;
+                                            });
+                            }),
+        agrpc::with_notify_when_done);
     asio::spawn(get_executor(),
                 [&](asio::yield_context yield)
                 {
-                    grpc_context.stop();
                     test::v1::Request request;
-                    grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
-                    ok = agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request,
-                                        writer, yield);
+                    client_context.set_deadline(test::hundred_milliseconds_from_now());
+                    auto reader =
+                        stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, response, status, yield));
+                    CHECK_EQ(grpc::StatusCode::DEADLINE_EXCEEDED, status.error_code());
+                    grpc::Alarm alarm;
+                    while (!is_cancelled)
+                    {
+                        agrpc::wait(alarm, test::ten_milliseconds_from_now(), yield);
+                    }
+                    grpc_context.stop();
                 });
     grpc_context.run();
-    CHECK_FALSE(ok);
+    CHECK(is_cancelled);
 }
 
-TEST_CASE_FIXTURE(test::GrpcContextTest, "asio::post an Alarm and use variadic-arg callback for its wait")
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+TEST_CASE_FIXTURE(GrpcRepeatedlyRequestTest,
+                  "repeatedly_request with_notify_when_done does not emit the cancellation slot of finished RPCs")
 {
-    bool ok = false;
-    grpc::Alarm alarm;
-    asio::post(get_executor(),
-               [&]
-               {
-                   agrpc::wait(alarm, test::ten_milliseconds_from_now(),
-                               asio::bind_executor(get_executor(),
-                                                   [&](auto&&... args)
-                                                   {
-                                                       ok = bool{args...};
-                                                   }));
-               });
+    bool is_emitted{false};
+    bool is_finished{false};
+    agrpc::repeatedly_request(
+        &test::v1::Test::AsyncService::RequestUnary, service,
+        asio::bind_executor(get_executor(),
+                            [&](auto&& rpc_context, bool ok)
+                            {
+                                if (!ok)
+                                {
+                                    return;
+                                }
+                                rpc_context.cancellation_slot().assign(
+                                    [&](asio::cancellation_type)
+                                    {
+                                        is_emitted = true;
+                                    });
+                                asio::spawn(get_executor(),
+                                            [&, rpc_context = std::move(rpc_context)](asio::yield_context yield)
+                                            {
+                                                auto& writer = std::get<2>(rpc_context.args());
+                                                test::v1::Response response;
+                                                agrpc::finish(writer, response, grpc::Status::OK, yield);
+                                                // Keep the RPC alive until the notification has been delivered
+                                                grpc::Alarm alarm;
+                                                agrpc::wait(alarm, test::hundred_milliseconds_from_now(), yield);
+                                                is_finished = true;
+                                                grpc_context.stop();
+                                            });
+                            }),
+        agrpc::with_notify_when_done);
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    auto reader =
+                        stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, response, status, yield));
+                    CHECK(status.ok());
+                });
     grpc_context.run();
-    CHECK(ok);
+    CHECK(is_finished);
+    CHECK_FALSE(is_emitted);
 }
+#endif
 
-#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
-TEST_CASE_FIXTURE(test::GrpcContextTest, "cancel grpc::Alarm with cancellation_type::total")
+TEST_CASE_FIXTURE(GrpcRepeatedlyRequestTest, "child contexts inherit the deadline and cancellation of the server RPC")
 {
-    bool ok = true;
-    asio::cancellation_signal signal{};
-    grpc::Alarm alarm;
-    asio::post(get_executor(),
-               [&]
-               {
-                   agrpc::wait(alarm, std::chrono::system_clock::now() + std::chrono::seconds(3),
-                               asio::bind_cancellation_slot(signal.slot(), asio::bind_executor(get_executor(),
-                                                                                               [&](bool alarm_ok)
-                                                                                               {
-                                                                                                   ok = alarm_ok;
-                                                                                               })));
-                   asio::post(get_executor(),
-                              [&]
-                              {
-                                  signal.emit(asio::cancellation_type::total);
-                              });
-               });
+    std::optional<grpc::StatusCode> child_status_code;
+    bool is_child_deadline_shortened{false};
+    bool is_downstream_cancelled{false};
+    const auto stop_when_done = [&]
+    {
+        if (child_status_code && is_downstream_cancelled)
+        {
+            grpc_context.stop();
+        }
+    };
+    agrpc::repeatedly_request(
+        &test::v1::Test::AsyncService::RequestClientStreaming, service,
+        asio::bind_executor(get_executor(),
+                            [&](auto&& rpc_context, bool ok)
+                            {
+                                if (!ok)
+                                {
+                                    return;
+                                }
+                                asio::spawn(get_executor(),
+                                            [&, rpc_context = std::move(rpc_context)](asio::yield_context yield)
+                                            {
+                                                grpc::Alarm alarm;
+                                                while (!rpc_context.is_cancelled())
+                                                {
+                                                    agrpc::wait(alarm, test::ten_milliseconds_from_now(), yield);
+                                                }
+                                                is_downstream_cancelled = true;
+                                                stop_when_done();
+                                            });
+                            }),
+        agrpc::with_notify_when_done);
+    agrpc::repeatedly_request(
+        &test::v1::Test::AsyncService::RequestUnary, service,
+        asio::bind_executor(
+            get_executor(),
+            [&](auto&& rpc_context, bool ok)
+            {
+                if (!ok)
+                {
+                    return;
+                }
+                asio::spawn(get_executor(),
+                            [&, rpc_context = std::move(rpc_context)](asio::yield_context yield)
+                            {
+                                auto& server_context = std::get<0>(rpc_context.args());
+                                auto child = rpc_context.create_child_context(std::chrono::seconds(1));
+                                // The RPC does not keep its children alive
+                                CHECK_EQ(1, child.use_count());
+                                is_child_deadline_shortened =
+                                    child->deadline() < server_context.deadline() - std::chrono::milliseconds(900);
+                                test::v1::Response response;
+                                auto [writer, request_ok] = agrpc::request(&test::v1::Test::Stub::AsyncClientStreaming,
+                                                                           *stub, *child, response, yield);
+                                grpc::Status status;
+                                agrpc::finish(*writer, status, yield);
+                                child_status_code = status.error_code();
+                                stop_when_done();
+                            });
+            }),
+        agrpc::with_notify_when_done);
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    auto reader =
+                        stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                    grpc::Alarm alarm;
+                    agrpc::wait(alarm, test::hundred_milliseconds_from_now(),
+                                asio::bind_executor(get_executor(),
+                                                    [&](bool)
+                                                    {
+                                                        client_context.TryCancel();
+                                                    }));
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, response, status, yield));
+                    CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+                });
     grpc_context.run();
-    CHECK_FALSE(ok);
+    CHECK(is_child_deadline_shortened);
+    CHECK_EQ(grpc::StatusCode::CANCELLED, child_status_code);
+    CHECK(is_downstream_cancelled);
 }
 
-TEST_CASE_FIXTURE(test::GrpcContextTest, "cancel grpc::Alarm with cancellation_type::none")
+struct GrpcProxyTest : test::GrpcClientServerTest
 {
-    bool ok = false;
-    asio::cancellation_signal signal{};
-    grpc::Alarm alarm;
-    asio::post(get_executor(),
-               [&]
-               {
-                   agrpc::wait(alarm, test::hundred_milliseconds_from_now(),
-                               asio::bind_cancellation_slot(signal.slot(), asio::bind_executor(get_executor(),
-                                                                                               [&](bool alarm_ok)
-                                                                                               {
-                                                                                                   ok = alarm_ok;
-                                                                                               })));
-                   asio::post(get_executor(),
-                              [&]
-                              {
-                                  signal.emit(asio::cancellation_type::none);
-                              });
-               });
+    grpc::ServerBuilder proxy_builder;
+    grpc::AsyncGenericService generic_service;
+    std::unique_ptr<grpc::Server> proxy_server;
+    agrpc::GrpcContext proxy_grpc_context{proxy_builder.AddCompletionQueue()};
+    grpc::GenericStub backend_stub{
+        grpc::CreateChannel(std::string{"localhost:"} + std::to_string(port), grpc::InsecureChannelCredentials())};
+    std::unique_ptr<test::v1::Test::Stub> proxy_stub;
+
+    GrpcProxyTest()
+    {
+        const auto proxy_port = test::get_free_port();
+        proxy_builder.AddListeningPort(std::string{"0.0.0.0:"} + std::to_string(proxy_port),
+                                       grpc::InsecureServerCredentials());
+        proxy_builder.RegisterAsyncGenericService(&generic_service);
+        proxy_server = proxy_builder.BuildAndStart();
+        proxy_stub = test::v1::Test::NewStub(grpc::CreateChannel(std::string{"localhost:"} + std::to_string(proxy_port),
+                                                                 grpc::InsecureChannelCredentials()));
+    }
+
+    ~GrpcProxyTest()
+    {
+        proxy_stub.reset();
+        proxy_server->Shutdown();
+    }
+};
+
+template <class Multimap>
+std::string find_metadata(const Multimap& metadata, std::string_view key)
+{
+    const auto it = metadata.find(grpc::string_ref{key.data(), key.size()});
+    if (it == metadata.end())
+    {
+        return {};
+    }
+    return std::string{it->second.data(), it->second.size()};
+}
+
+TEST_CASE_FIXTURE(GrpcProxyTest, "Proxy forwards unary and bidirectional streaming RPCs")
+{
+    agrpc::Proxy proxy{proxy_grpc_context, generic_service, [&](grpc::GenericServerContext&) -> grpc::GenericStub&
+                       {
+                           return backend_stub;
+                       }};
+    proxy.start();
+    std::thread proxy_thread{[&]
+                             {
+                                 proxy_grpc_context.run();
+                             }};
+    client_context.AddMetadata("x-proxy-test", "forwarded");
+    SUBCASE("unary")
+    {
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        test::v1::Request request;
+                        grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+                        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context,
+                                             request, writer, yield));
+                        CHECK_EQ(42, request.integer());
+                        CHECK_EQ("forwarded", find_metadata(server_context.client_metadata(), "x-proxy-test"));
+                        CHECK_LE(server_context.deadline(), std::chrono::system_clock::now() + std::chrono::seconds(6));
+                        server_context.AddInitialMetadata("x-initial", "initial");
+                        server_context.AddTrailingMetadata("x-trailing", "trailing");
+                        test::v1::Response response;
+                        response.set_integer(21);
+                        CHECK(agrpc::finish(writer, response, grpc::Status::OK, yield));
+                    });
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        test::v1::Request request;
+                        request.set_integer(42);
+                        auto reader = proxy_stub->AsyncUnary(&client_context, request,
+                                                             agrpc::get_completion_queue(get_executor()));
+                        test::v1::Response response;
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader, response, status, yield));
+                        CHECK(status.ok());
+                        CHECK_EQ(21, response.integer());
+                        CHECK_EQ("initial", find_metadata(client_context.GetServerInitialMetadata(), "x-initial"));
+                        CHECK_EQ("trailing", find_metadata(client_context.GetServerTrailingMetadata(), "x-trailing"));
+                    });
+    }
+    SUBCASE("bidirectional streaming")
+    {
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        grpc::ServerAsyncReaderWriter<test::v1::Response, test::v1::Request> reader_writer{
+                            &server_context};
+                        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service,
+                                             server_context, reader_writer, yield));
+                        CHECK_EQ("forwarded", find_metadata(server_context.client_metadata(), "x-proxy-test"));
+                        test::v1::Request request;
+                        test::v1::Response response;
+                        while (agrpc::read(reader_writer, request, yield))
+                        {
+                            response.set_integer(request.integer() * 2);
+                            CHECK(agrpc::write(reader_writer, response, yield));
+                        }
+                        CHECK(agrpc::finish(reader_writer, grpc::Status{grpc::StatusCode::ALREADY_EXISTS, "done"},
+                                            yield));
+                    });
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        auto [reader_writer, ok] = agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming,
+                                                                  *proxy_stub, client_context, yield);
+                        CHECK(ok);
+                        test::v1::Request request;
+                        test::v1::Response response;
+                        for (int i = 1; i <= 3; ++i)
+                        {
+                            request.set_integer(i);
+                            CHECK(agrpc::write(*reader_writer, request, yield));
+                            CHECK(agrpc::read(*reader_writer, response, yield));
+                            CHECK_EQ(i * 2, response.integer());
+                        }
+                        CHECK(agrpc::writes_done(*reader_writer, yield));
+                        CHECK_FALSE(agrpc::read(*reader_writer, response, yield));
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader_writer, status, yield));
+                        CHECK_EQ(grpc::StatusCode::ALREADY_EXISTS, status.error_code());
+                        CHECK_EQ("done", status.error_message());
+                    });
+    }
+    SUBCASE("backend ends the stream before the client half-closes")
+    {
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        grpc::ServerAsyncReaderWriter<test::v1::Response, test::v1::Request> reader_writer{
+                            &server_context};
+                        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service,
+                                             server_context, reader_writer, yield));
+                        test::v1::Request request;
+                        CHECK(agrpc::read(reader_writer, request, yield));
+                        CHECK(agrpc::finish(reader_writer, grpc::Status{grpc::StatusCode::ABORTED, "early"}, yield));
+                    });
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        auto [reader_writer, ok] = agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming,
+                                                                  *proxy_stub, client_context, yield);
+                        CHECK(ok);
+                        test::v1::Request request;
+                        request.set_integer(1);
+                        CHECK(agrpc::write(*reader_writer, request, yield));
+                        test::v1::Response response;
+                        CHECK_FALSE(agrpc::read(*reader_writer, response, yield));
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader_writer, status, yield));
+                        CHECK_EQ(grpc::StatusCode::ABORTED, status.error_code());
+                    });
+    }
+    SUBCASE("stopped proxy rejects calls")
+    {
+        proxy.stop();
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        test::v1::Request request;
+                        auto reader = proxy_stub->AsyncUnary(&client_context, request,
+                                                             agrpc::get_completion_queue(get_executor()));
+                        test::v1::Response response;
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader, response, status, yield));
+                        CHECK_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+                    });
+    }
     grpc_context.run();
-    CHECK(ok);
+    proxy_grpc_context.stop();
+    proxy_thread.join();
+}
+
+TEST_CASE("ResponseCache evicts least recently used entries and expired entries")
+{
+    test::v1::Response response;
+    response.set_integer(42);
+    const auto key = [](int i)
+    {
+        test::v1::Request request;
+        request.set_integer(i);
+        return *agrpc::ResponseCache::make_key("/agrpc.test.v1.Test/Unary", request);
+    };
+    SUBCASE("memory budget")
+    {
+        const auto entry_size = [&]
+        {
+            agrpc::ResponseCache cache{1024};
+            cache.insert(key(1), response);
+            return cache.used_memory();
+        }();
+        agrpc::ResponseCache cache{3 * entry_size};
+        cache.insert(key(1), response);
+        cache.insert(key(2), response);
+        cache.insert(key(3), response);
+        CHECK_EQ(3, cache.size());
+        CHECK(cache.find(key(1)));
+        cache.insert(key(4), response);
+        CHECK_EQ(3, cache.size());
+        CHECK(cache.find(key(1)));
+        CHECK_FALSE(cache.find(key(2)));
+        CHECK(cache.find(key(3)));
+        CHECK(cache.find(key(4)));
+    }
+    SUBCASE("time to live")
+    {
+        agrpc::ResponseCache cache{1024, std::chrono::milliseconds(1)};
+        cache.insert(key(1), response);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK_FALSE(cache.find(key(1)));
+        CHECK_EQ(0, cache.used_memory());
+    }
+    SUBCASE("key includes method")
+    {
+        agrpc::ResponseCache cache{1024};
+        cache.insert(key(1), response);
+        test::v1::Request request;
+        request.set_integer(1);
+        CHECK_FALSE(cache.find(*agrpc::ResponseCache::make_key("/agrpc.test.v1.Test/Other", request)));
+    }
+}
+
+template <class Service>
+struct GrpcRawServiceTest : test::GrpcContextTest
+{
+    Service service;
+    std::shared_ptr<grpc::Channel> channel;
+    std::unique_ptr<test::v1::Test::Stub> stub;
+
+    GrpcRawServiceTest()
+    {
+        const auto port = test::get_free_port();
+        builder.AddListeningPort(std::string{"0.0.0.0:"} + std::to_string(port), grpc::InsecureServerCredentials());
+        builder.RegisterService(&service);
+        server = builder.BuildAndStart();
+        channel =
+            grpc::CreateChannel(std::string{"localhost:"} + std::to_string(port), grpc::InsecureChannelCredentials());
+        stub = test::v1::Test::NewStub(channel);
+    }
+
+    ~GrpcRawServiceTest()
+    {
+        stub.reset();
+        channel.reset();
+        server->Shutdown();
+    }
+};
+
+using RawUnaryService = test::v1::Test::WithRawMethod_Unary<test::v1::Test::AsyncService>;
+using GrpcRawUnaryTest = GrpcRawServiceTest<RawUnaryService>;
+
+TEST_CASE_FIXTURE(GrpcRawUnaryTest, "ResponseCache finishes raw unary RPCs with cached responses")
+{
+    agrpc::ResponseCache cache{1024};
+    int computed_responses{};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        grpc::ServerContext server_context;
+                        grpc::ByteBuffer request_buffer;
+                        grpc::ServerAsyncResponseWriter<grpc::ByteBuffer> writer{&server_context};
+                        CHECK(agrpc::request(
+                            &RawUnaryService::RequestUnary, service,
+                            server_context, request_buffer, writer, yield));
+                        auto key = agrpc::ResponseCache::make_key("/agrpc.test.v1.Test/Unary", request_buffer);
+                        REQUIRE(key);
+                        if (const auto* cached = cache.find(*key))
+                        {
+                            CHECK(agrpc::finish(writer, *cached, grpc::Status::OK, yield));
+                            continue;
+                        }
+                        ++computed_responses;
+                        test::v1::Request request;
+                        CHECK(grpc::SerializationTraits<test::v1::Request>::Deserialize(&request_buffer, &request)
+                                  .ok());
+                        test::v1::Response response;
+                        response.set_integer(request.integer() * 2);
+                        const auto response_buffer = cache.insert(std::move(*key), response);
+                        CHECK(agrpc::finish(writer, response_buffer, grpc::Status::OK, yield));
+                    }
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    for (const auto value : {21, 21, 4, 21})
+                    {
+                        grpc::ClientContext client_context;
+                        test::v1::Request request;
+                        request.set_integer(value);
+                        auto reader =
+                            stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                        test::v1::Response response;
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader, response, status, yield));
+                        CHECK(status.ok());
+                        CHECK_EQ(value * 2, response.integer());
+                    }
+                });
+    grpc_context.run();
+    CHECK_EQ(2, computed_responses);
+    CHECK_EQ(2, cache.size());
+}
+
+using RawServerStreamingService = test::v1::Test::WithRawMethod_ServerStreaming<test::v1::Test::AsyncService>;
+using GrpcRawServerStreamingTest = GrpcRawServiceTest<RawServerStreamingService>;
+
+TEST_CASE_FIXTURE(GrpcRawServerStreamingTest, "Broadcaster writes serialized messages to all subscribers")
+{
+    std::size_t max_queued_messages{8};
+    auto overflow_policy{agrpc::BroadcastOverflowPolicy::DROP_OLDEST};
+    int expected_messages{3};
+    bool expected_ok{true};
+    SUBCASE("deliver all messages") {}
+    SUBCASE("drop newest messages")
+    {
+        max_queued_messages = 0;
+        overflow_policy = agrpc::BroadcastOverflowPolicy::DROP_NEWEST;
+        expected_messages = 1;
+    }
+    SUBCASE("disconnect slow subscribers")
+    {
+        max_queued_messages = 0;
+        overflow_policy = agrpc::BroadcastOverflowPolicy::DISCONNECT;
+        expected_ok = false;
+    }
+    agrpc::Broadcaster broadcaster{grpc_context, max_queued_messages, overflow_policy};
+    static constexpr int SUBSCRIBER_COUNT = 2;
+    for (int i = 0; i < SUBSCRIBER_COUNT; ++i)
+    {
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        grpc::ServerContext server_context;
+                        grpc::ByteBuffer request;
+                        grpc::ServerAsyncWriter<grpc::ByteBuffer> writer{&server_context};
+                        CHECK(agrpc::request(&RawServerStreamingService::RequestServerStreaming, service,
+                                             server_context, request, writer, yield));
+                        if (broadcaster.size() == SUBSCRIBER_COUNT - 1)
+                        {
+                            asio::post(grpc_context,
+                                       [&]
+                                       {
+                                           for (int j = 1; j <= 3; ++j)
+                                           {
+                                               test::v1::Response response;
+                                               response.set_integer(j);
+                                               CHECK(broadcaster.publish(response));
+                                           }
+                                           broadcaster.close();
+                                       });
+                        }
+                        const bool ok = broadcaster.subscribe(server_context, writer, yield);
+                        CHECK_EQ(expected_ok, ok);
+                        if (ok)
+                        {
+                            CHECK(agrpc::finish(writer, grpc::Status::OK, yield));
+                        }
+                    });
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        grpc::ClientContext client_context;
+                        test::v1::Request request;
+                        std::unique_ptr<grpc::ClientAsyncReader<test::v1::Response>> reader;
+                        CHECK(agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub, client_context,
+                                             request, reader, yield));
+                        int message_count{};
+                        test::v1::Response response;
+                        while (agrpc::read(*reader, response, yield))
+                        {
+                            ++message_count;
+                            CHECK_EQ(message_count, response.integer());
+                        }
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader, status, yield));
+                        if (expected_ok)
+                        {
+                            CHECK(status.ok());
+                            CHECK_EQ(expected_messages, message_count);
+                        }
+                        else
+                        {
+                            CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
+                        }
+                    });
+    }
+    grpc_context.run();
+    CHECK_EQ(0, broadcaster.size());
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "StreamWriter writes messages from coroutines and other threads")
+{
+    static constexpr int MESSAGES_PER_PRODUCER = 5;
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming, service, server_context,
+                                         request, writer, yield));
+                    agrpc::StreamWriter stream_writer{grpc_context, writer, 2};
+                    std::atomic_int thread_writes{};
+                    std::thread producer{[&]
+                                         {
+                                             for (int i = 0; i < MESSAGES_PER_PRODUCER; ++i)
+                                             {
+                                                 test::v1::Response response;
+                                                 response.set_integer(i);
+                                                 stream_writer.write(response, asio::bind_executor(grpc_context,
+                                                                                                   [&](bool ok)
+                                                                                                   {
+                                                                                                       CHECK(ok);
+                                                                                                       ++thread_writes;
+                                                                                                   }));
+                                             }
+                                         }};
+                    for (int i = 0; i < MESSAGES_PER_PRODUCER; ++i)
+                    {
+                        test::v1::Response response;
+                        response.set_integer(i);
+                        CHECK(stream_writer.write(response, yield));
+                    }
+                    producer.join();
+                    grpc::Alarm alarm;
+                    while (thread_writes < MESSAGES_PER_PRODUCER)
+                    {
+                        agrpc::wait(alarm, test::ten_milliseconds_from_now(), yield);
+                    }
+                    CHECK(stream_writer.flush(yield));
+                    CHECK(agrpc::finish(writer, grpc::Status::OK, yield));
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    std::unique_ptr<grpc::ClientAsyncReader<test::v1::Response>> reader;
+                    CHECK(agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub, client_context, request,
+                                         reader, yield));
+                    int message_count{};
+                    test::v1::Response response;
+                    while (agrpc::read(*reader, response, yield))
+                    {
+                        ++message_count;
+                    }
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, status, yield));
+                    CHECK(status.ok());
+                    CHECK_EQ(2 * MESSAGES_PER_PRODUCER, message_count);
+                });
+    grpc_context.run();
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "StreamReader reads ahead into recycled messages")
+{
+    static constexpr int MESSAGE_COUNT = 10;
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    grpc::ServerAsyncWriter<test::v1::Response> writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestServerStreaming, service, server_context,
+                                         request, writer, yield));
+                    for (int i = 1; i <= MESSAGE_COUNT; ++i)
+                    {
+                        test::v1::Response response;
+                        response.set_integer(i);
+                        CHECK(agrpc::write(writer, response, yield));
+                    }
+                    CHECK(agrpc::finish(writer, grpc::Status::OK, yield));
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    std::unique_ptr<grpc::ClientAsyncReader<test::v1::Response>> reader;
+                    CHECK(agrpc::request(&test::v1::Test::Stub::AsyncServerStreaming, *stub, client_context, request,
+                                         reader, yield));
+                    agrpc::StreamReader stream_reader{grpc_context, *reader, 3};
+                    std::set<const test::v1::Response*> slots;
+                    int message_count{};
+                    while (auto* response = stream_reader.next(yield))
+                    {
+                        ++message_count;
+                        CHECK_EQ(message_count, response->integer());
+                        slots.emplace(response);
+                    }
+                    CHECK_EQ(MESSAGE_COUNT, message_count);
+                    CHECK_GE(3, slots.size());
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, status, yield));
+                    CHECK(status.ok());
+                });
+    grpc_context.run();
+}
+
+struct GrpcBidiEchoBenchmark : test::GrpcClientServerTest
+{
+    using ServerReaderWriter = grpc::ServerAsyncReaderWriter<test::v1::Response, test::v1::Request>;
+    using ClientReaderWriter = grpc::ClientAsyncReaderWriter<test::v1::Request, test::v1::Response>;
+
+    static constexpr int MESSAGE_COUNT = 1000;
+
+    int received_messages{};
+
+    void sequential_server(asio::yield_context yield)
+    {
+        grpc::ServerContext server_context;
+        ServerReaderWriter reader_writer{&server_context};
+        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service, server_context,
+                             reader_writer, yield));
+        test::v1::Request request;
+        while (agrpc::read(reader_writer, request, yield))
+        {
+            test::v1::Response response;
+            response.set_integer(request.integer());
+            CHECK(agrpc::write(reader_writer, response, yield));
+        }
+        CHECK(agrpc::finish(reader_writer, grpc::Status::OK, yield));
+    }
+
+    void sequential_client(asio::yield_context yield)
+    {
+        grpc::ClientContext client_context;
+        std::unique_ptr<ClientReaderWriter> reader_writer;
+        CHECK(agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming, *stub, client_context,
+                             reader_writer, yield));
+        for (int i = 0; i < MESSAGE_COUNT; ++i)
+        {
+            test::v1::Request request;
+            request.set_integer(i);
+            CHECK(agrpc::write(*reader_writer, request, yield));
+            test::v1::Response response;
+            CHECK(agrpc::read(*reader_writer, response, yield));
+            received_messages += static_cast<int>(response.integer() == i);
+        }
+        CHECK(agrpc::writes_done(*reader_writer, yield));
+        grpc::Status status;
+        CHECK(agrpc::finish(*reader_writer, status, yield));
+        CHECK(status.ok());
+    }
+
+    void duplex_server(asio::yield_context yield)
+    {
+        grpc::ServerContext server_context;
+        ServerReaderWriter reader_writer{&server_context};
+        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service, server_context,
+                             reader_writer, yield));
+        agrpc::Duplex duplex{grpc_context, reader_writer, server_context};
+        duplex.start_reading(
+            [&](test::v1::Request& request)
+            {
+                test::v1::Response response;
+                response.set_integer(request.integer());
+                duplex.write(std::move(response), asio::bind_executor(grpc_context, [](bool) {}));
+            });
+        CHECK(duplex.finish_after_reads(grpc::Status::OK, yield));
+    }
+
+    void duplex_client(asio::yield_context yield)
+    {
+        grpc::ClientContext client_context;
+        std::unique_ptr<ClientReaderWriter> reader_writer;
+        CHECK(agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming, *stub, client_context,
+                             reader_writer, yield));
+        agrpc::Duplex duplex{grpc_context, *reader_writer, client_context};
+        int expected{};
+        duplex.start_reading(
+            [&](test::v1::Response& response)
+            {
+                received_messages += static_cast<int>(response.integer() == expected);
+                ++expected;
+            });
+        for (int i = 0; i < MESSAGE_COUNT; ++i)
+        {
+            test::v1::Request request;
+            request.set_integer(i);
+            CHECK(duplex.write(std::move(request), yield));
+        }
+        grpc::Status status;
+        CHECK(duplex.finish(status, yield));
+        CHECK(status.ok());
+    }
+
+    template <class Server, class Client>
+    auto measure(Server server, Client client)
+    {
+        received_messages = 0;
+        grpc_context.reset();
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        (this->*server)(yield);
+                    });
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        (this->*client)(yield);
+                    });
+        const auto start = std::chrono::steady_clock::now();
+        grpc_context.run();
+        CHECK_EQ(MESSAGE_COUNT, received_messages);
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+};
+
+TEST_CASE_FIXTURE(GrpcBidiEchoBenchmark, "Duplex bidi echo throughput compared to sequential read-then-write")
+{
+    const auto sequential =
+        measure(&GrpcBidiEchoBenchmark::sequential_server, &GrpcBidiEchoBenchmark::sequential_client);
+    const auto duplex = measure(&GrpcBidiEchoBenchmark::duplex_server, &GrpcBidiEchoBenchmark::duplex_client);
+    MESSAGE("bidi echo of " << MESSAGE_COUNT << " messages: sequential " << sequential.count() << "us, duplex "
+                            << duplex.count() << "us");
+}
+
+TEST_CASE_FIXTURE(GrpcBidiEchoBenchmark, "Duplex server finishes while a read is pending")
+{
+    bool is_read_done{false};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ServerContext server_context;
+                    ServerReaderWriter reader_writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service,
+                                         server_context, reader_writer, yield));
+                    agrpc::Duplex duplex{grpc_context, reader_writer, server_context};
+                    duplex.start_reading([](test::v1::Request&) {},
+                                         [&]
+                                         {
+                                             is_read_done = true;
+                                         });
+                    CHECK(duplex.finish(grpc::Status{grpc::StatusCode::ABORTED, {}}, yield));
+                    CHECK(is_read_done);
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ClientContext client_context;
+                    std::unique_ptr<ClientReaderWriter> reader_writer;
+                    CHECK(agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming, *stub, client_context,
+                                         reader_writer, yield));
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader_writer, status, yield));
+                    CHECK_EQ(grpc::StatusCode::ABORTED, status.error_code());
+                });
+    grpc_context.run();
+}
+
+using RawBidirectionalStreamingService =
+    test::v1::Test::WithRawMethod_BidirectionalStreaming<test::v1::Test::AsyncService>;
+
+struct GrpcMultiplexBenchmark : GrpcRawServiceTest<RawBidirectionalStreamingService>
+{
+    using Client = agrpc::MultiplexedClient<test::v1::Request, test::v1::Response>;
+    using Server = agrpc::MultiplexedServer<test::v1::Request, test::v1::Response>;
+
+    static constexpr int CALL_COUNT = 1000;
+    static constexpr int CONCURRENCY = 8;
+
+    grpc::GenericStub generic_stub{channel};
+    int completed_calls{};
+
+    void unary_server(asio::yield_context yield)
+    {
+        for (int i = 0; i < CALL_COUNT / CONCURRENCY; ++i)
+        {
+            grpc::ServerContext server_context;
+            test::v1::Request request;
+            grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+            CHECK(agrpc::request(&RawBidirectionalStreamingService::RequestUnary, service, server_context, request,
+                                 writer, yield));
+            test::v1::Response response;
+            response.set_integer(request.integer());
+            CHECK(agrpc::finish(writer, response, grpc::Status::OK, yield));
+        }
+    }
+
+    void unary_client(asio::yield_context yield)
+    {
+        for (int i = 0; i < CALL_COUNT / CONCURRENCY; ++i)
+        {
+            grpc::ClientContext client_context;
+            test::v1::Request request;
+            request.set_integer(i);
+            auto reader = stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+            test::v1::Response response;
+            grpc::Status status;
+            CHECK(agrpc::finish(*reader, response, status, yield));
+            completed_calls += static_cast<int>(status.ok() && response.integer() == i);
+        }
+    }
+
+    void multiplexed_server(asio::yield_context yield)
+    {
+        grpc::ServerContext server_context;
+        grpc::GenericServerAsyncReaderWriter reader_writer{&server_context};
+        CHECK(agrpc::request(&RawBidirectionalStreamingService::RequestBidirectionalStreaming, service,
+                             server_context, reader_writer, yield));
+        Server server{grpc_context, reader_writer, server_context};
+        server.start(
+            [](test::v1::Request& request, Server::Responder responder)
+            {
+                test::v1::Response response;
+                response.set_integer(request.integer());
+                responder(response);
+            });
+        CHECK(server.finish(grpc::Status::OK, yield));
+    }
+
+    void multiplexed_client(asio::yield_context yield)
+    {
+        grpc::ClientContext client_context;
+        std::unique_ptr<grpc::GenericClientAsyncReaderWriter> reader_writer;
+        CHECK(agrpc::request("/agrpc.test.v1.Test/BidirectionalStreaming", generic_stub, client_context,
+                             reader_writer, yield));
+        Client client{grpc_context, *reader_writer, client_context};
+        client.start();
+        grpc::Alarm all_done;
+        int running{CONCURRENCY};
+        for (int i = 0; i < CONCURRENCY; ++i)
+        {
+            asio::spawn(get_executor(),
+                        [&](asio::yield_context yield)
+                        {
+                            for (int j = 0; j < CALL_COUNT / CONCURRENCY; ++j)
+                            {
+                                test::v1::Request request;
+                                request.set_integer(j);
+                                test::v1::Response response;
+                                const auto ok = client.request(request, response, yield);
+                                completed_calls += static_cast<int>(ok && response.integer() == j);
+                            }
+                            if (--running == 0)
+                            {
+                                all_done.Cancel();
+                            }
+                        });
+        }
+        CHECK_FALSE(agrpc::wait(all_done, std::chrono::system_clock::now() + std::chrono::seconds(5), yield));
+        CHECK_EQ(0, client.pending());
+        grpc::Status status;
+        CHECK(client.finish(status, yield));
+        CHECK(status.ok());
+    }
+
+    template <class ServerFunction, class ClientFunction>
+    auto measure(ServerFunction server, ClientFunction client, int server_count, int client_count)
+    {
+        completed_calls = 0;
+        grpc_context.reset();
+        for (int i = 0; i < server_count; ++i)
+        {
+            asio::spawn(get_executor(),
+                        [&](asio::yield_context yield)
+                        {
+                            (this->*server)(yield);
+                        });
+        }
+        for (int i = 0; i < client_count; ++i)
+        {
+            asio::spawn(get_executor(),
+                        [&](asio::yield_context yield)
+                        {
+                            (this->*client)(yield);
+                        });
+        }
+        const auto start = std::chrono::steady_clock::now();
+        grpc_context.run();
+        CHECK_EQ(CALL_COUNT, completed_calls);
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+};
+
+TEST_CASE_FIXTURE(GrpcMultiplexBenchmark, "MultiplexedClient matches responses that arrive out of order")
+{
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ServerContext server_context;
+                    grpc::GenericServerAsyncReaderWriter reader_writer{&server_context};
+                    CHECK(agrpc::request(&RawBidirectionalStreamingService::RequestBidirectionalStreaming, service,
+                                         server_context, reader_writer, yield));
+                    Server server{grpc_context, reader_writer, server_context};
+                    std::vector<std::pair<int, Server::Responder>> requests;
+                    server.start(
+                        [&](test::v1::Request& request, Server::Responder responder)
+                        {
+                            requests.emplace_back(request.integer(), responder);
+                            if (requests.size() == 3)
+                            {
+                                for (auto it = requests.rbegin(); it != requests.rend(); ++it)
+                                {
+                                    test::v1::Response response;
+                                    response.set_integer(it->first * 10);
+                                    it->second(response);
+                                }
+                            }
+                        });
+                    CHECK(server.finish(grpc::Status::OK, yield));
+                });
+    std::vector<int> completion_order;
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ClientContext client_context;
+                    std::unique_ptr<grpc::GenericClientAsyncReaderWriter> reader_writer;
+                    CHECK(agrpc::request("/agrpc.test.v1.Test/BidirectionalStreaming", generic_stub, client_context,
+                                         reader_writer, yield));
+                    Client client{grpc_context, *reader_writer, client_context};
+                    client.start();
+                    std::array<test::v1::Response, 3> responses;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        test::v1::Request request;
+                        request.set_integer(i + 1);
+                        client.request(request, responses[i],
+                                       asio::bind_executor(grpc_context,
+                                                           [&, i](bool ok)
+                                                           {
+                                                               CHECK(ok);
+                                                               CHECK_EQ((i + 1) * 10, responses[i].integer());
+                                                               completion_order.push_back(i);
+                                                           }));
+                    }
+                    CHECK_EQ(3, client.pending());
+                    grpc::Status status;
+                    CHECK(client.finish(status, yield));
+                    CHECK(status.ok());
+                    CHECK_EQ(0, client.pending());
+                });
+    grpc_context.run();
+    CHECK_EQ((std::vector<int>{2, 1, 0}), completion_order);
+}
+
+TEST_CASE_FIXTURE(GrpcMultiplexBenchmark, "MultiplexedClient fails calls when the stream breaks")
+{
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ServerContext server_context;
+                    grpc::GenericServerAsyncReaderWriter reader_writer{&server_context};
+                    CHECK(agrpc::request(&RawBidirectionalStreamingService::RequestBidirectionalStreaming, service,
+                                         server_context, reader_writer, yield));
+                    CHECK(agrpc::finish(reader_writer, grpc::Status{grpc::StatusCode::UNAVAILABLE, {}}, yield));
+                });
+    bool is_request_done{false};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ClientContext client_context;
+                    std::unique_ptr<grpc::GenericClientAsyncReaderWriter> reader_writer;
+                    CHECK(agrpc::request("/agrpc.test.v1.Test/BidirectionalStreaming", generic_stub, client_context,
+                                         reader_writer, yield));
+                    Client client{grpc_context, *reader_writer, client_context};
+                    client.start();
+                    test::v1::Request request;
+                    test::v1::Response response;
+                    CHECK_FALSE(client.request(request, response, yield));
+                    is_request_done = true;
+                    grpc::Status status;
+                    client.finish(status, yield);
+                    CHECK_EQ(0, client.pending());
+                });
+    grpc_context.run();
+    CHECK(is_request_done);
+}
+
+TEST_CASE_FIXTURE(GrpcMultiplexBenchmark, "MultiplexedClient throughput compared to plain unary calls")
+{
+    const auto unary =
+        measure(&GrpcMultiplexBenchmark::unary_server, &GrpcMultiplexBenchmark::unary_client, CONCURRENCY, CONCURRENCY);
+    const auto multiplexed =
+        measure(&GrpcMultiplexBenchmark::multiplexed_server, &GrpcMultiplexBenchmark::multiplexed_client, 1, 1);
+    MESSAGE(CALL_COUNT << " calls with " << CONCURRENCY << " in flight: unary " << unary.count() << "us, multiplexed "
+                       << multiplexed.count() << "us");
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "hedged_request sends another attempt when the first one is slow")
+{
+    bool is_first_attempt_slow{true};
+    SUBCASE("slow first attempt") {}
+    SUBCASE("fast first attempt") { is_first_attempt_slow = false; }
+    const auto initial_delay =
+        is_first_attempt_slow ? std::chrono::milliseconds(10) : std::chrono::milliseconds(std::chrono::seconds(5));
+    agrpc::LatencyTracker latency_tracker{0.95, 16, initial_delay};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request first_request;
+                    grpc::ServerAsyncResponseWriter<test::v1::Response> first_writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context,
+                                         first_request, first_writer, yield));
+                    test::v1::Response response;
+                    if (is_first_attempt_slow)
+                    {
+                        grpc::ServerContext second_server_context;
+                        test::v1::Request second_request;
+                        grpc::ServerAsyncResponseWriter<test::v1::Response> second_writer{&second_server_context};
+                        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service,
+                                             second_server_context, second_request, second_writer, yield));
+                        response.set_integer(second_request.integer());
+                        CHECK(agrpc::finish(second_writer, response, grpc::Status::OK, yield));
+                    }
+                    response.set_integer(first_request.integer());
+                    agrpc::finish(first_writer, response, grpc::Status::OK, yield);
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::hedged_request(
+                        latency_tracker, 2,
+                        [&](grpc::ClientContext& client_context, grpc::CompletionQueue* cq, std::size_t attempt)
+                        {
+                            client_context.set_deadline(std::chrono::system_clock::now() +
+                                                        std::chrono::seconds(5));
+                            test::v1::Request request;
+                            request.set_integer(static_cast<int32_t>(attempt));
+                            return stub->AsyncUnary(&client_context, request, cq);
+                        },
+                        response, status, yield));
+                    CHECK(status.ok());
+                    CHECK_EQ(is_first_attempt_slow ? 1 : 0, response.integer());
+                });
+    grpc_context.run();
+    CHECK_EQ(1, latency_tracker.size());
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "retry restarts unary requests that fail with a retryable status")
+{
+    bool is_budget_exhausted{false};
+    SUBCASE("within budget") {}
+    SUBCASE("exhausted budget")
+    {
+        is_budget_exhausted = true;
+        asio::use_service<agrpc::RetryBudget>(grpc_context).configure(2.0, 0.1);
+    }
+    const int expected_request_count = is_budget_exhausted ? 1 : 3;
+    int request_count{};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    for (int i = 0; i < expected_request_count; ++i)
+                    {
+                        grpc::ServerContext server_context;
+                        test::v1::Request request;
+                        grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+                        CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context,
+                                             request, writer, yield));
+                        CHECK_EQ(i, request.integer());
+                        ++request_count;
+                        if (i < 2)
+                        {
+                            CHECK(agrpc::finish_with_error(writer, grpc::Status{grpc::StatusCode::UNAVAILABLE, ""},
+                                                           yield));
+                        }
+                        else
+                        {
+                            test::v1::Response response;
+                            response.set_integer(42);
+                            CHECK(agrpc::finish(writer, response, grpc::Status::OK, yield));
+                        }
+                    }
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    agrpc::RetryPolicy policy;
+                    policy.initial_backoff = std::chrono::milliseconds(5);
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::retry(
+                        policy,
+                        [&](grpc::ClientContext& client_context, grpc::CompletionQueue* cq, std::size_t attempt)
+                        {
+                            client_context.set_deadline(std::chrono::system_clock::now() +
+                                                        std::chrono::seconds(5));
+                            test::v1::Request request;
+                            request.set_integer(static_cast<int32_t>(attempt));
+                            return stub->AsyncUnary(&client_context, request, cq);
+                        },
+                        response, status, yield));
+                    if (is_budget_exhausted)
+                    {
+                        CHECK_EQ(grpc::StatusCode::UNAVAILABLE, status.error_code());
+                    }
+                    else
+                    {
+                        CHECK(status.ok());
+                        CHECK_EQ(42, response.integer());
+                    }
+                });
+    grpc_context.run();
+    CHECK_EQ(expected_request_count, request_count);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "ChannelPool picks the channel with the fewest in-flight calls")
+{
+    agrpc::ChannelPool<test::v1::Test::Stub> channel_pool{address, grpc::InsecureChannelCredentials(), 3};
+    std::vector<agrpc::ChannelPool<test::v1::Test::Stub>::Lease> leases;
+    for (int i = 0; i < 3; ++i)
+    {
+        leases.emplace_back(channel_pool.pick());
+    }
+    for (std::size_t i = 0; i < channel_pool.size(); ++i)
+    {
+        CHECK_EQ(1, channel_pool.in_flight(i));
+    }
+    {
+        auto lease = channel_pool.pick(1, 2);
+        CHECK_EQ(2, channel_pool.in_flight(1));
+    }
+    CHECK_EQ(1, channel_pool.in_flight(1));
+    CHECK_THROWS_AS(static_cast<void>(channel_pool.pick(0, 0)), std::invalid_argument);
+    CHECK_THROWS_AS((agrpc::ChannelPool<test::v1::Test::Stub>{address, grpc::InsecureChannelCredentials(), 0}),
+                    std::invalid_argument);
+    leases.clear();
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request,
+                                         writer, yield));
+                    test::v1::Response response;
+                    response.set_integer(request.integer());
+                    CHECK(agrpc::finish(writer, response, grpc::Status::OK, yield));
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    auto lease = channel_pool.pick();
+                    test::v1::Request request;
+                    request.set_integer(42);
+                    auto reader =
+                        lease->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                    test::v1::Response response;
+                    grpc::Status status;
+                    CHECK(agrpc::finish(*reader, response, status, yield));
+                    CHECK(status.ok());
+                    CHECK_EQ(42, response.integer());
+                });
+    grpc_context.run();
+}
+
+struct GrpcBalancerTest : test::GrpcContextTest
+{
+    struct Backend
+    {
+        grpc::ServerBuilder builder;
+        test::v1::Test::AsyncService service;
+        std::unique_ptr<grpc::Server> server;
+        agrpc::GrpcContext grpc_context{builder.AddCompletionQueue()};
+        std::string address;
+        std::atomic_int request_count{};
+        std::optional<std::thread> thread;
+    };
+
+    std::array<Backend, 3> backends;
+
+    GrpcBalancerTest()
+    {
+        for (auto& backend : backends)
+        {
+            const auto port = test::get_free_port();
+            backend.address = std::string{"localhost:"} + std::to_string(port);
+            backend.builder.AddListeningPort(std::string{"0.0.0.0:"} + std::to_string(port),
+                                             grpc::InsecureServerCredentials());
+            backend.builder.RegisterService(&backend.service);
+            backend.server = backend.builder.BuildAndStart();
+        }
+    }
+
+    struct UnaryRPC
+    {
+        grpc::ServerContext server_context;
+        test::v1::Request request;
+        grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+    };
+
+    void start_backend(Backend& backend, std::chrono::milliseconds delay)
+    {
+        asio::spawn(backend.grpc_context,
+                    [&, delay](asio::yield_context yield)
+                    {
+                        while (true)
+                        {
+                            auto rpc = std::make_shared<UnaryRPC>();
+                            if (!agrpc::request(&test::v1::Test::AsyncService::RequestUnary, backend.service,
+                                                rpc->server_context, rpc->request, rpc->writer, yield))
+                            {
+                                return;
+                            }
+                            ++backend.request_count;
+                            asio::spawn(backend.grpc_context,
+                                        [rpc, delay](asio::yield_context yield)
+                                        {
+                                            grpc::Alarm alarm;
+                                            agrpc::wait(alarm, std::chrono::system_clock::now() + delay, yield);
+                                            test::v1::Response response;
+                                            response.set_integer(rpc->request.integer());
+                                            agrpc::finish(rpc->writer, response, grpc::Status::OK, yield);
+                                        });
+                        }
+                    });
+        backend.thread.emplace(
+            [&]
+            {
+                backend.grpc_context.run();
+            });
+    }
+
+    ~GrpcBalancerTest()
+    {
+        for (auto& backend : backends)
+        {
+            backend.server->Shutdown();
+            if (backend.thread)
+            {
+                backend.thread->join();
+            }
+        }
+    }
+};
+
+TEST_CASE_FIXTURE(GrpcBalancerTest, "PowerOfTwoChoicesBalancer sends fewer requests to a slow backend")
+{
+    start_backend(backends[0], std::chrono::milliseconds(1));
+    start_backend(backends[1], std::chrono::milliseconds(1));
+    start_backend(backends[2], std::chrono::milliseconds(50));
+    agrpc::PowerOfTwoChoicesBalancer<test::v1::Test::Stub> balancer{
+        {backends[0].address, backends[1].address, backends[2].address}, grpc::InsecureChannelCredentials()};
+    CHECK_THROWS_AS((agrpc::PowerOfTwoChoicesBalancer<test::v1::Test::Stub>{{}, grpc::InsecureChannelCredentials()}),
+                    std::invalid_argument);
+    for (int i = 0; i < 4; ++i)
+    {
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        for (int j = 0; j < 15; ++j)
+                        {
+                            auto pick = balancer.pick();
+                            grpc::ClientContext client_context;
+                            client_context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+                            test::v1::Request request;
+                            request.set_integer(j);
+                            auto reader =
+                                pick->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                            test::v1::Response response;
+                            grpc::Status status;
+                            CHECK(balancer.finish(std::move(pick), *reader, response, status, yield));
+                            CHECK(status.ok());
+                            CHECK_EQ(j, response.integer());
+                        }
+                    });
+    }
+    grpc_context.run();
+    for (std::size_t i = 0; i < balancer.size(); ++i)
+    {
+        CHECK_EQ(0, balancer.in_flight(i));
+    }
+    CHECK_EQ(60, backends[0].request_count + backends[1].request_count + backends[2].request_count);
+    CHECK_LT(backends[2].request_count, backends[0].request_count);
+    CHECK_LT(backends[2].request_count, backends[1].request_count);
+    CHECK_GT(balancer.latency(2), balancer.latency(0));
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Batcher flushes when the batch is full or the linger timer expires")
+{
+    bool is_batch_answered{true};
+    SUBCASE("answered batches") {}
+    SUBCASE("dropped batches") { is_batch_answered = false; }
+    std::vector<std::size_t> batch_sizes;
+    agrpc::Batcher<int, int> batcher{grpc_context, 3, std::chrono::milliseconds(20),
+                                     [&](agrpc::Batcher<int, int>::Batch batch)
+                                     {
+                                         batch_sizes.push_back(batch.requests().size());
+                                         if (!is_batch_answered)
+                                         {
+                                             return;
+                                         }
+                                         asio::post(grpc_context,
+                                                    [batch = std::move(batch)]() mutable
+                                                    {
+                                                        for (const auto request : batch.requests())
+                                                        {
+                                                            batch.responses().push_back(request * 2);
+                                                        }
+                                                        std::move(batch)(true);
+                                                    });
+                                     }};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::chrono::steady_clock::duration> latencies(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        asio::spawn(get_executor(),
+                    [&, i](asio::yield_context yield)
+                    {
+                        int response{};
+                        CHECK_EQ(is_batch_answered, batcher.submit(i, response, yield));
+                        CHECK_EQ(is_batch_answered ? i * 2 : 0, response);
+                        latencies[i] = std::chrono::steady_clock::now() - start;
+                    });
+    }
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::size_t>{3, 1}), batch_sizes);
+    CHECK_LT(latencies[2], std::chrono::milliseconds(20));
+    CHECK_GE(latencies[3], std::chrono::milliseconds(20));
+    CHECK_EQ(0, batcher.size());
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "when_idle completes after all ready work has run")
+{
+    std::vector<int> order;
+    asio::post(grpc_context,
+               [&]
+               {
+                   agrpc::when_idle(grpc_context,
+                                    [&]
+                                    {
+                                        order.push_back(0);
+                                        agrpc::when_idle(grpc_context,
+                                                         [&]
+                                                         {
+                                                             order.push_back(3);
+                                                         });
+                                        asio::post(grpc_context,
+                                                   [&]
+                                                   {
+                                                       order.push_back(2);
+                                                   });
+                                    });
+                   asio::post(grpc_context,
+                              [&]
+                              {
+                                  order.push_back(1);
+                              });
+               });
+    grpc_context.run();
+    CHECK_EQ((std::vector<int>{1, 0, 2, 3}), order);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "when_idle does not starve the completion queue")
+{
+    static constexpr int MAX_IDLE_COUNT = 100000;
+    grpc::Alarm alarm;
+    bool is_alarm_done{false};
+    int idle_count{};
+    agrpc::wait(alarm, std::chrono::system_clock::now(),
+                asio::bind_executor(grpc_context,
+                                    [&](bool)
+                                    {
+                                        is_alarm_done = true;
+                                    }));
+    std::function<void()> wait_for_idle;
+    wait_for_idle = [&]
+    {
+        if (!is_alarm_done && ++idle_count < MAX_IDLE_COUNT)
+        {
+            agrpc::when_idle(grpc_context, wait_for_idle);
+        }
+    };
+    asio::post(grpc_context, wait_for_idle);
+    grpc_context.run();
+    CHECK(is_alarm_done);
+    CHECK_LT(idle_count, MAX_IDLE_COUNT);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "Batcher with zero linger flushes once per loop turn")
+{
+    std::vector<std::size_t> batch_sizes;
+    agrpc::Batcher<int, int> batcher{grpc_context, 10, {},
+                                     [&](agrpc::Batcher<int, int>::Batch batch)
+                                     {
+                                         batch_sizes.push_back(batch.requests().size());
+                                         for (const auto request : batch.requests())
+                                         {
+                                             batch.responses().push_back(request + 1);
+                                         }
+                                         std::move(batch)(true);
+                                     }};
+    for (int i = 0; i < 5; ++i)
+    {
+        asio::spawn(get_executor(),
+                    [&, i](asio::yield_context yield)
+                    {
+                        int response{};
+                        CHECK(batcher.submit(i, response, yield));
+                        CHECK_EQ(i + 1, response);
+                    });
+    }
+    grpc_context.run();
+    CHECK_EQ((std::vector<std::size_t>{5}), batch_sizes);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "SingleFlight coalesces identical unary requests")
+{
+    agrpc::SingleFlight<test::v1::Response> single_flight{grpc_context};
+    int request_count{};
+    std::vector<std::shared_ptr<const test::v1::Response>> results;
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    test::v1::Request request;
+                    grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+                    CHECK(agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request,
+                                         writer, yield));
+                    ++request_count;
+                    test::v1::Response response;
+                    response.set_integer(request.integer() * 2);
+                    CHECK(agrpc::finish(writer, response, grpc::Status::OK, yield));
+                });
+    const auto call_unary = [&](agrpc::SingleFlight<test::v1::Response>::Resolver resolver)
+    {
+        asio::spawn(get_executor(),
+                    [&, resolver = std::move(resolver)](asio::yield_context yield) mutable
+                    {
+                        test::v1::Request request;
+                        request.set_integer(21);
+                        auto reader =
+                            stub->AsyncUnary(&client_context, request, agrpc::get_completion_queue(get_executor()));
+                        test::v1::Response response;
+                        grpc::Status status;
+                        CHECK(agrpc::finish(*reader, response, status, yield));
+                        CHECK(status.ok());
+                        resolver(std::move(response));
+                    });
+    };
+    for (int i = 0; i < 3; ++i)
+    {
+        asio::spawn(get_executor(),
+                    [&](asio::yield_context yield)
+                    {
+                        results.emplace_back(single_flight.run("21", call_unary, yield));
+                    });
+    }
+    grpc_context.run();
+    CHECK_EQ(1, request_count);
+    CHECK_EQ(0, single_flight.size());
+    REQUIRE_EQ(3, results.size());
+    REQUIRE(results[0]);
+    CHECK_EQ(42, results[0]->integer());
+    CHECK_EQ(results[0], results[1]);
+    CHECK_EQ(results[0], results[2]);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "SingleFlight completes waiters with empty result when Resolver is dropped")
+{
+    agrpc::SingleFlight<grpc::ByteBuffer> single_flight{grpc_context};
+    int completion_count{};
+    const auto complete = [&](std::shared_ptr<const grpc::ByteBuffer> result)
+    {
+        CHECK_FALSE(result);
+        ++completion_count;
+    };
+    std::optional<agrpc::SingleFlight<grpc::ByteBuffer>::Resolver> resolver;
+    single_flight.run(
+        "key",
+        [&](auto&& new_resolver)
+        {
+            resolver.emplace(std::move(new_resolver));
+        },
+        asio::bind_executor(grpc_context, complete));
+    single_flight.run(
+        "key",
+        [&](auto&&)
+        {
+            CHECK(false);
+        },
+        asio::bind_executor(grpc_context, complete));
+    CHECK(single_flight.is_in_flight("key"));
+    asio::post(grpc_context,
+               [&]
+               {
+                   resolver.reset();
+               });
+    grpc_context.run();
+    CHECK_EQ(2, completion_count);
+    CHECK_FALSE(single_flight.is_in_flight("key"));
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "RPC step after grpc_context stop")
+{
+    std::optional<bool> ok;
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc_context.stop();
+                    test::v1::Request request;
+                    grpc::ServerAsyncResponseWriter<test::v1::Response> writer{&server_context};
+                    ok = agrpc::request(&test::v1::Test::AsyncService::RequestUnary, service, server_context, request,
+                                        writer, yield);
+                });
+    grpc_context.run();
+    CHECK_FALSE(ok);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "asio::post an Alarm and use variadic-arg callback for its wait")
+{
+    bool ok = false;
+    grpc::Alarm alarm;
+    asio::post(get_executor(),
+               [&]
+               {
+                   agrpc::wait(alarm, test::ten_milliseconds_from_now(),
+                               asio::bind_executor(get_executor(),
+                                                   [&](auto&&... args)
+                                                   {
+                                                       ok = bool{args...};
+                                                   }));
+               });
+    grpc_context.run();
+    CHECK(ok);
+}
+
+#ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
+TEST_CASE_FIXTURE(test::GrpcContextTest, "cancel grpc::Alarm with cancellation_type::total")
+{
+    bool ok = true;
+    asio::cancellation_signal signal{};
+    grpc::Alarm alarm;
+    asio::post(get_executor(),
+               [&]
+               {
+                   agrpc::wait(alarm, std::chrono::system_clock::now() + std::chrono::seconds(3),
+                               asio::bind_cancellation_slot(signal.slot(), asio::bind_executor(get_executor(),
+                                                                                               [&](bool alarm_ok)
+                                                                                               {
+                                                                                                   ok = alarm_ok;
+                                                                                               })));
+                   asio::post(get_executor(),
+                              [&]
+                              {
+                                  signal.emit(asio::cancellation_type::total);
+                              });
+               });
+    grpc_context.run();
+    CHECK_FALSE(ok);
+}
+
+TEST_CASE_FIXTURE(test::GrpcContextTest, "cancel grpc::Alarm with cancellation_type::none")
+{
+    bool ok = false;
+    asio::cancellation_signal signal{};
+    grpc::Alarm alarm;
+    asio::post(get_executor(),
+               [&]
+               {
+                   agrpc::wait(alarm, test::hundred_milliseconds_from_now(),
+                               asio::bind_cancellation_slot(signal.slot(), asio::bind_executor(get_executor(),
+                                                                                               [&](bool alarm_ok)
+                                                                                               {
+                                                                                                   ok = alarm_ok;
+                                                                                               })));
+                   asio::post(get_executor(),
+                              [&]
+                              {
+                                  signal.emit(asio::cancellation_type::none);
+                              });
+               });
+    grpc_context.run();
+    CHECK(ok);
+}
+
+TEST_CASE_FIXTURE(test::GrpcClientServerTest, "cancel client read with cancellation_type::total")
+{
+    bool read_ok = true;
+    grpc::Status status;
+    asio::cancellation_signal signal{};
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    grpc::ServerAsyncReaderWriter<test::v1::Response, test::v1::Request> reader_writer{&server_context};
+                    agrpc::request(&test::v1::Test::AsyncService::RequestBidirectionalStreaming, service,
+                                   server_context, reader_writer, yield);
+                });
+    asio::spawn(get_executor(),
+                [&](asio::yield_context yield)
+                {
+                    auto [reader_writer, ok] = agrpc::request(&test::v1::Test::Stub::AsyncBidirectionalStreaming,
+                                                              *stub, client_context, yield);
+                    CHECK(ok);
+                    test::v1::Response response;
+                    agrpc::read(client_context, *reader_writer, response,
+                                asio::bind_cancellation_slot(signal.slot(), asio::bind_executor(get_executor(),
+                                                                                                [&](bool is_ok)
+                                                                                                {
+                                                                                                    read_ok = is_ok;
+                                                                                                })));
+                    signal.emit(asio::cancellation_type::total);
+                    agrpc::finish(*reader_writer, status, yield);
+                });
+    grpc_context.run();
+    CHECK_FALSE(read_ok);
+    CHECK_EQ(grpc::StatusCode::CANCELLED, status.error_code());
 }
 #endif
 
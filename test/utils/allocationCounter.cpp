@@ -0,0 +1,78 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/allocationCounter.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace agrpc::test
+{
+namespace
+{
+thread_local std::size_t* current_allocation_count{};
+}  // namespace
+
+AllocationCounter::AllocationCounter() noexcept : previous(std::exchange(current_allocation_count, &this->allocations))
+{
+}
+
+AllocationCounter::~AllocationCounter() { current_allocation_count = this->previous; }
+
+std::size_t AllocationCounter::count() const noexcept { return this->allocations; }
+}  // namespace agrpc::test
+
+// Every replaceable non-aligned form is replaced so that sanitizers never see mismatching allocation functions
+void* operator new(std::size_t size)
+{
+    if (agrpc::test::current_allocation_count != nullptr)
+    {
+        ++*agrpc::test::current_allocation_count;
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return ::operator new(size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return ::operator new(size, std::nothrow); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete[](void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
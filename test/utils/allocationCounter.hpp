@@ -0,0 +1,42 @@
+// Copyright 2021 Dennis Hezel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef AGRPC_UTILS_ALLOCATIONCOUNTER_HPP
+#define AGRPC_UTILS_ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+namespace agrpc::test
+{
+// Counts calls to the global operator new that are made by the current thread while the counter is alive
+class AllocationCounter
+{
+  public:
+    AllocationCounter() noexcept;
+
+    AllocationCounter(const AllocationCounter&) = delete;
+
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    ~AllocationCounter();
+
+    [[nodiscard]] std::size_t count() const noexcept;
+
+  private:
+    std::size_t allocations{};
+    std::size_t* previous;
+};
+}  // namespace agrpc::test
+
+#endif  // AGRPC_UTILS_ALLOCATIONCOUNTER_HPP
@@ -18,9 +18,11 @@
 #ifdef AGRPC_STANDALONE_ASIO
 #include <asio/coroutine.hpp>
 #include <asio/execution/allocator.hpp>
+#include <asio/io_context.hpp>
 #include <asio/post.hpp>
 #include <asio/spawn.hpp>
 #include <asio/steady_timer.hpp>
+#include <asio/strand.hpp>
 #include <asio/thread_pool.hpp>
 
 #ifdef AGRPC_ASIO_HAS_CO_AWAIT
@@ -30,6 +32,10 @@
 #ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
 #include <asio/bind_cancellation_slot.hpp>
 #include <asio/cancellation_signal.hpp>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+#include <asio/experimental/awaitable_operators.hpp>
+#endif
 #endif
 
 #ifdef ASIO_HAS_CONCEPTS
@@ -41,9 +47,11 @@
 //
 #include <boost/asio/coroutine.hpp>
 #include <boost/asio/execution/allocator.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/asio/spawn.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/asio/thread_pool.hpp>
 
 #ifdef AGRPC_ASIO_HAS_CO_AWAIT
@@ -53,6 +61,10 @@
 #ifdef AGRPC_ASIO_HAS_CANCELLATION_SLOT
 #include <boost/asio/bind_cancellation_slot.hpp>
 #include <boost/asio/cancellation_signal.hpp>
+
+#ifdef AGRPC_ASIO_HAS_CO_AWAIT
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#endif
 #endif
 
 #ifdef BOOST_ASIO_HAS_CONCEPTS
@@ -64,11 +76,13 @@
 #include <unifex/sync_wait.hpp>
 #include <unifex/task.hpp>
 #include <unifex/when_all.hpp>
+#elif defined(AGRPC_STDEXEC)
+#include <stdexec/execution.hpp>
 #endif
 
 namespace agrpc::test
 {
-#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_UNIFEX)
+#if defined(AGRPC_STANDALONE_ASIO) || defined(AGRPC_UNIFEX) || defined(AGRPC_STDEXEC)
 using ErrorCode = std::error_code;
 #elif defined(AGRPC_BOOST_ASIO)
 using ErrorCode = boost::system::error_code;